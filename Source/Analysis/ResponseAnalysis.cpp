@@ -0,0 +1,190 @@
+#include "ResponseAnalysis.h"
+
+namespace iir
+{
+
+//==============================================================================
+FrequencyGrid::FrequencyGrid (std::vector<double> frequenciesHz, double newSampleRate)
+    : frequencies (std::move (frequenciesHz)),
+      sampleRate (newSampleRate)
+{
+    jassert (sampleRate > 0.0);
+
+    const auto n = frequencies.size();
+    cos1.resize (n);
+    sin1.resize (n);
+    cos2.resize (n);
+    sin2.resize (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        frequencies[i] = juce::jlimit (0.0, 0.5 * sampleRate, frequencies[i]);
+
+        const auto w = juce::MathConstants<double>::twoPi * frequencies[i] / sampleRate;
+        cos1[i] = std::cos (w);
+        sin1[i] = std::sin (w);
+        cos2[i] = std::cos (2.0 * w);
+        sin2[i] = std::sin (2.0 * w);
+    }
+}
+
+FrequencyGrid FrequencyGrid::linear (double lowHz, double highHz, int numPoints, double sampleRate)
+{
+    std::vector<double> frequencies ((size_t) juce::jmax (0, numPoints));
+
+    for (size_t i = 0; i < frequencies.size(); ++i)
+        frequencies[i] = numPoints > 1 ? lowHz + (highHz - lowHz) * (double) i / (double) (numPoints - 1) : lowHz;
+
+    return { std::move (frequencies), sampleRate };
+}
+
+FrequencyGrid FrequencyGrid::logarithmic (double lowHz, double highHz, int numPoints, double sampleRate)
+{
+    jassert (lowHz > 0.0 && highHz > 0.0);
+
+    std::vector<double> frequencies ((size_t) juce::jmax (0, numPoints));
+    const auto octaves = std::log2 (highHz / lowHz);
+
+    for (size_t i = 0; i < frequencies.size(); ++i)
+        frequencies[i] = numPoints > 1 ? lowHz * std::exp2 (octaves * (double) i / (double) (numPoints - 1)) : lowHz;
+
+    return { std::move (frequencies), sampleRate };
+}
+
+//==============================================================================
+struct ResponseEvaluator
+{
+    static constexpr size_t framesPerRun = 256;
+
+    /** Multiplies the running response (re, im) by one section's and adds its
+        group delay, at every frequency.
+
+        For a polynomial P (z^-1) = sum c_k z^-k on the unit circle, the group
+        delay is Re (sum k c_k z^-k / P): the numerator's less the
+        denominator's gives the section's. At a zero of the numerator on the
+        unit circle the delay is undefined, and there that section's
+        numerator adds nothing.
+    */
+    static void accumulate (const BiquadCoefficients<double>& s,
+                            const double* __restrict cos1, const double* __restrict sin1,
+                            const double* __restrict cos2, const double* __restrict sin2,
+                            double* __restrict re, double* __restrict im, double* __restrict delay,
+                            int numFrequencies) noexcept
+    {
+        const auto b0 = s.b0, b1 = s.b1, b2 = s.b2, a1 = s.a1, a2 = s.a2;
+
+        // Closer than this to a zero, rounding decides the delay
+        const auto minNorm = 1.0e-20 * (b0 * b0 + b1 * b1 + b2 * b2);
+
+        for (int i = 0; i < numFrequencies; ++i)
+        {
+            const auto nr = b0 + b1 * cos1[i] + b2 * cos2[i];
+            const auto ni = -(b1 * sin1[i] + b2 * sin2[i]);
+            const auto dr = 1.0 + a1 * cos1[i] + a2 * cos2[i];
+            const auto di = -(a1 * sin1[i] + a2 * sin2[i]);
+
+            const auto ndr = b1 * cos1[i] + 2.0 * b2 * cos2[i];
+            const auto ndi = -(b1 * sin1[i] + 2.0 * b2 * sin2[i]);
+            const auto ddr = a1 * cos1[i] + 2.0 * a2 * cos2[i];
+            const auto ddi = -(a1 * sin1[i] + 2.0 * a2 * sin2[i]);
+
+            // No branch around the division, so the loop vectorises
+            const auto nn = nr * nr + ni * ni;
+            const auto invNN = (nn > minNorm ? 1.0 : 0.0) / juce::jmax (nn, minNorm);
+            const auto invDD = 1.0 / (dr * dr + di * di);
+
+            delay[i] += (ndr * nr + ndi * ni) * invNN - (ddr * dr + ddi * di) * invDD;
+
+            // N / D = N conj (D) / |D|^2
+            const auto qr = (nr * dr + ni * di) * invDD;
+            const auto qi = (ni * dr - nr * di) * invDD;
+            const auto r = re[i], m = im[i];
+            re[i] = r * qr - m * qi;
+            im[i] = r * qi + m * qr;
+        }
+    }
+
+    static void evaluate (const BiquadCoefficients<double>* sections, int numSections,
+                          const FrequencyGrid& grid, FrequencyResponse& result)
+    {
+        const auto n = (size_t) grid.size();
+
+        // The running response goes in the result's own arrays, then becomes
+        // the magnitude and phase in place
+        auto& re = result.magnitude;
+        auto& im = result.phase;
+        re.assign (n, 1.0);
+        im.assign (n, 0.0);
+        result.groupDelay.assign (n, 0.0);
+
+        // A run of frequencies goes through every section before the next, so
+        // its trigonometry and running response stay in L1 throughout
+        for (size_t start = 0; start < n; start += framesPerRun)
+        {
+            const auto length = (int) juce::jmin (framesPerRun, n - start);
+
+            for (int s = 0; s < numSections; ++s)
+                accumulate (sections[s],
+                            grid.cos1.data() + start, grid.sin1.data() + start, grid.cos2.data() + start, grid.sin2.data() + start,
+                            re.data() + start, im.data() + start, result.groupDelay.data() + start, length);
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto r = re[i], m = im[i];
+            re[i] = std::hypot (r, m);
+            im[i] = std::atan2 (m, r);
+        }
+    }
+};
+
+//==============================================================================
+void ResponseAnalysis::evaluate (const BiquadCoefficients<double>* sections, int numSections,
+                                 const FrequencyGrid& grid, FrequencyResponse& result)
+{
+    ResponseEvaluator::evaluate (sections, numSections, grid, result);
+}
+
+FrequencyResponse ResponseAnalysis::evaluate (const Sections& sections, const FrequencyGrid& grid)
+{
+    FrequencyResponse result;
+    ResponseEvaluator::evaluate (sections.data(), (int) sections.size(), grid, result);
+    return result;
+}
+
+std::vector<FrequencyResponse> ResponseAnalysis::evaluate (const std::vector<Sections>& cascades, const FrequencyGrid& grid)
+{
+    std::vector<FrequencyResponse> results (cascades.size());
+
+    for (size_t i = 0; i < cascades.size(); ++i)
+        ResponseEvaluator::evaluate (cascades[i].data(), (int) cascades[i].size(), grid, results[i]);
+
+    return results;
+}
+
+ResponseAnalysis::Sections ResponseAnalysis::getSections (const FilterSettings& settings, double sampleRate)
+{
+    Sections sections;
+
+    const auto addCut = [&] (CutSlot slot)
+    {
+        const auto& cut = settings.cuts[(size_t) slot];
+
+        if (cut.enabled)
+        {
+            const auto design = CascadeDesigner::design (CascadeSpec::fromSettings (cut, slot == lowCut, sampleRate));
+            sections.insert (sections.end(), design.sections.begin(), design.sections.end());
+        }
+    };
+
+    addCut (lowCut);
+
+    for (const auto& band : settings.bands)
+        if (band.enabled)
+            sections.push_back (BiquadCoefficients<double>::design (band, sampleRate));
+
+    addCut (highCut);
+    return sections;
+}
+
+} // namespace iir
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../DSP/CascadeDesigner.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** The frequencies a response is evaluated at, with the sines and cosines
+    of each one's phase advance per sample worked out once, so any number of
+    cascades can be evaluated over the same grid without recomputing them.
+*/
+class FrequencyGrid
+{
+public:
+    /** Any frequencies, in Hz, in any order. Frequencies are clamped to
+        between 0 and Nyquist.
+    */
+    FrequencyGrid (std::vector<double> frequenciesHz, double sampleRate);
+
+    /** numPoints frequencies spaced evenly from lowHz to highHz, both included. */
+    static FrequencyGrid linear (double lowHz, double highHz, int numPoints, double sampleRate);
+
+    /** numPoints frequencies spaced evenly in octaves from lowHz to highHz, both included. */
+    static FrequencyGrid logarithmic (double lowHz, double highHz, int numPoints, double sampleRate);
+
+    int size() const noexcept                         { return (int) frequencies.size(); }
+    double getFrequency (int index) const noexcept    { return frequencies[(size_t) index]; }
+    double getSampleRate() const noexcept             { return sampleRate; }
+
+private:
+    friend struct ResponseEvaluator;
+
+    std::vector<double> frequencies;
+    double sampleRate;
+
+    // cos and sin of w and 2w, where w is the frequency in radians per sample
+    std::vector<double> cos1, sin1, cos2, sin2;
+};
+
+//==============================================================================
+/** A cascade's response at every frequency of a grid. */
+struct FrequencyResponse
+{
+    std::vector<double> magnitude;    // linear
+    std::vector<double> phase;        // radians, wrapped to [-pi, pi]
+    std::vector<double> groupDelay;   // samples; divide by the sample rate for seconds
+
+    double getMagnitudeDb (int index) const noexcept
+    {
+        return 20.0 * std::log10 (juce::jmax (1.0e-30, magnitude[(size_t) index]));
+    }
+};
+
+//==============================================================================
+/** Magnitude, phase and group delay of cascades of second-order sections,
+    for tools that check designs offline rather than for the plug-in itself.
+
+    The frequencies are the lanes: each section updates the running response
+    of a whole run of frequencies at once, from contiguous arrays, so the
+    inner loop vectorises. The group delay is exact, from the derivative of
+    each section's numerator and denominator, rather than a difference of
+    phases.
+*/
+namespace ResponseAnalysis
+{
+    using Sections = std::vector<BiquadCoefficients<double>>;
+
+    /** Evaluates one cascade. result is resized to the grid. */
+    void evaluate (const BiquadCoefficients<double>* sections, int numSections,
+                   const FrequencyGrid& grid, FrequencyResponse& result);
+
+    FrequencyResponse evaluate (const Sections& sections, const FrequencyGrid& grid);
+
+    /** Evaluates a batch of cascades over the same grid, one response each,
+        in the same order.
+    */
+    std::vector<FrequencyResponse> evaluate (const std::vector<Sections>& cascades, const FrequencyGrid& grid);
+
+    /** The sections the filter engine would run for these settings: the low
+        cut, the enabled bands in order, then the high cut, as heard on a
+        channel every band acts on. Dynamic bands are taken at rest; the hum
+        notches, modulated band, resonators and crossover aren't included.
+    */
+    Sections getSections (const FilterSettings& settings, double sampleRate);
+}
+
+} // namespace iir
@@ -0,0 +1,31 @@
+#include "Arena.h"
+
+namespace iir
+{
+
+//==============================================================================
+void Arena::allocate (size_t numBytes)
+{
+    release();
+
+    size = roundUp (numBytes);
+
+    if (size == 0)
+        return;
+
+    // The extra line both aligns the start and keeps the neighbouring heap
+    // block off the last line in use
+    block.calloc (size + 2 * alignment);
+    const auto address = reinterpret_cast<std::uintptr_t> (block.get());
+    start = block.get() + (roundUp (address) - address);
+}
+
+void Arena::release() noexcept
+{
+    block.free();
+    start = nullptr;
+    size = 0;
+    used = 0;
+}
+
+} // namespace iir
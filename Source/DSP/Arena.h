@@ -0,0 +1,78 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace iir
+{
+
+//==============================================================================
+/** A single block of cache-line-aligned memory that DSP state is carved from.
+
+    Everything an instance touches per block is allocated in one go when it
+    is prepared and freed in one go when it is released, so it sits in one
+    contiguous range rather than scattered over the heap. Every allocation
+    starts on a cache line and the block is padded to whole lines, so no two
+    instances, and no two allocations, ever share a line.
+
+    Only trivially destructible types can be carved from it: release() just
+    frees the memory.
+*/
+class Arena
+{
+public:
+    Arena() = default;
+
+    static constexpr size_t alignment = 64;
+
+    /** Bytes that numObjects objects of type T take up in the arena. */
+    template <typename T>
+    static constexpr size_t getBytesFor (size_t numObjects) noexcept
+    {
+        return roundUp (numObjects * sizeof (T));
+    }
+
+    /** Frees any previous block and allocates a zeroed one of at least
+        numBytes. Not real-time safe.
+    */
+    void allocate (size_t numBytes);
+
+    /** Frees the block; everything carved from it becomes invalid. */
+    void release() noexcept;
+
+    size_t getSize() const noexcept  { return size; }
+    size_t getUsed() const noexcept  { return used; }
+
+    /** Carves numObjects value-initialised objects from the block. The space
+        must have been accounted for with getBytesFor() when allocating.
+    */
+    template <typename T>
+    T* take (size_t numObjects) noexcept
+    {
+        static_assert (std::is_trivially_destructible_v<T> && alignof (T) <= alignment);
+
+        const auto numBytes = getBytesFor<T> (numObjects);
+        jassert (used + numBytes <= size);
+
+        auto* objects = reinterpret_cast<T*> (start + used);
+        used += numBytes;
+
+        for (size_t i = 0; i < numObjects; ++i)
+            new (objects + i) T();
+
+        return objects;
+    }
+
+private:
+    static constexpr size_t roundUp (size_t numBytes) noexcept
+    {
+        return (numBytes + alignment - 1) / alignment * alignment;
+    }
+
+    juce::HeapBlock<char> block;
+    char* start = nullptr;
+    size_t size = 0, used = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Arena)
+};
+
+} // namespace iir
@@ -0,0 +1,106 @@
+#include "BiquadCoefficients.h"
+#include "DesignTables.h"
+
+namespace iir
+{
+
+template <typename SampleType>
+BiquadCoefficients<SampleType> BiquadCoefficients<SampleType>::design (const BandSettings& band, double sampleRate) noexcept
+{
+    jassert (sampleRate > 0.0);
+
+    // Keep the design away from DC and Nyquist, where the cookbook formulas degenerate
+    const auto frequency = juce::jlimit (1.0, sampleRate * 0.49, (double) band.frequency);
+    const auto q         = juce::jmax (1.0e-3, (double) band.q);
+
+    const auto w0    = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    const auto cosw0 = std::cos (w0);
+    const auto alpha = std::sin (w0) / (2.0 * q);
+    const auto A     = DesignTables::getAmplitude (band.gainDb);
+
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+
+    switch (band.type)
+    {
+        case FilterType::lowPass:
+            b0 = (1.0 - cosw0) * 0.5;  b1 = 1.0 - cosw0;     b2 = b0;
+            a0 = 1.0 + alpha;          a1 = -2.0 * cosw0;    a2 = 1.0 - alpha;
+            break;
+
+        case FilterType::highPass:
+            b0 = (1.0 + cosw0) * 0.5;  b1 = -(1.0 + cosw0);  b2 = b0;
+            a0 = 1.0 + alpha;          a1 = -2.0 * cosw0;    a2 = 1.0 - alpha;
+            break;
+
+        case FilterType::bandPass:
+            b0 = alpha;                b1 = 0.0;             b2 = -alpha;
+            a0 = 1.0 + alpha;          a1 = -2.0 * cosw0;    a2 = 1.0 - alpha;
+            break;
+
+        case FilterType::notch:
+            b0 = 1.0;                  b1 = -2.0 * cosw0;    b2 = 1.0;
+            a0 = 1.0 + alpha;          a1 = -2.0 * cosw0;    a2 = 1.0 - alpha;
+            break;
+
+        case FilterType::peak:
+            b0 = 1.0 + alpha * A;      b1 = -2.0 * cosw0;    b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A;      a1 = -2.0 * cosw0;    a2 = 1.0 - alpha / A;
+            break;
+
+        case FilterType::lowShelf:
+        {
+            const auto sqrtA = 2.0 * std::sqrt (A) * alpha;
+            b0 =        A * ((A + 1.0) - (A - 1.0) * cosw0 + sqrtA);
+            b1 =  2.0 * A * ((A - 1.0) - (A + 1.0) * cosw0);
+            b2 =        A * ((A + 1.0) - (A - 1.0) * cosw0 - sqrtA);
+            a0 =             (A + 1.0) + (A - 1.0) * cosw0 + sqrtA;
+            a1 = -2.0 *     ((A - 1.0) + (A + 1.0) * cosw0);
+            a2 =             (A + 1.0) + (A - 1.0) * cosw0 - sqrtA;
+            break;
+        }
+
+        case FilterType::highShelf:
+        {
+            const auto sqrtA = 2.0 * std::sqrt (A) * alpha;
+            b0 =        A * ((A + 1.0) + (A - 1.0) * cosw0 + sqrtA);
+            b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosw0);
+            b2 =        A * ((A + 1.0) + (A - 1.0) * cosw0 - sqrtA);
+            a0 =             (A + 1.0) - (A - 1.0) * cosw0 + sqrtA;
+            a1 =  2.0 *     ((A - 1.0) - (A + 1.0) * cosw0);
+            a2 =             (A + 1.0) - (A - 1.0) * cosw0 - sqrtA;
+            break;
+        }
+    }
+
+    BiquadCoefficients c;
+    c.b0 = (SampleType) (b0 / a0);
+    c.b1 = (SampleType) (b1 / a0);
+    c.b2 = (SampleType) (b2 / a0);
+    c.a1 = (SampleType) (a1 / a0);
+    c.a2 = (SampleType) (a2 / a0);
+    return c;
+}
+
+template <typename SampleType>
+double BiquadCoefficients<SampleType>::getDecaySamples() const noexcept
+{
+    // The poles are the roots of z^2 + a1 z + a2
+    const auto p = (double) a1 * 0.5, q = (double) a2;
+    const auto discriminant = p * p - q;
+
+    const auto radius = discriminant < 0.0 ? std::sqrt (q)
+                                           : std::abs (p) + std::sqrt (discriminant);
+
+    if (radius == 0.0)
+        return 0.0;
+
+    if (radius >= 1.0)
+        return std::numeric_limits<double>::infinity();
+
+    return std::log (0.001) / std::log (radius);
+}
+
+template struct BiquadCoefficients<float>;
+template struct BiquadCoefficients<double>;
+
+} // namespace iir
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "FilterSettings.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** Normalised second-order section coefficients (a0 == 1).
+
+    The transfer function is
+        H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+*/
+template <typename SampleType>
+struct BiquadCoefficients
+{
+    SampleType b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+
+    /** Designs a section from a band description using the RBJ cookbook formulas.
+        The maths is always done in double precision.
+    */
+    static BiquadCoefficients design (const BandSettings& band, double sampleRate) noexcept;
+
+    /** A pass-through section. */
+    static BiquadCoefficients identity() noexcept  { return {}; }
+
+    /** How many samples the impulse response takes to fall by 60 dB, from
+        the radius of the pole closest to the unit circle: 0 without poles,
+        infinity if a pole is on or outside it.
+    */
+    double getDecaySamples() const noexcept;
+};
+
+extern template struct BiquadCoefficients<float>;
+extern template struct BiquadCoefficients<double>;
+
+} // namespace iir
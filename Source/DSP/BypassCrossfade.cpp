@@ -0,0 +1,109 @@
+#include "BypassCrossfade.h"
+
+namespace iir
+{
+
+//==============================================================================
+void BypassCrossfade::prepare (double sampleRate, int maxBlockSize, int numChannels, int latencySamples)
+{
+    jassert (sampleRate > 0.0 && maxBlockSize > 0);
+
+    dry.setSize (numChannels, maxBlockSize);
+    delayLine.setSize (numChannels, juce::jmax (0, latencySamples));
+    gainStep = (float) (1.0 / juce::jmax (1.0, fadeSeconds * sampleRate));
+    reset();
+}
+
+bool BypassCrossfade::setBypassed (bool shouldBeBypassed) noexcept
+{
+    const auto resuming = isFullyBypassed() && ! shouldBeBypassed;
+    bypassed = shouldBeBypassed;
+    return resuming;
+}
+
+void BypassCrossfade::reset() noexcept
+{
+    wetGain = bypassed ? 0.0f : 1.0f;
+    delayLine.clear();
+    delayPosition = 0;
+}
+
+//==============================================================================
+void BypassCrossfade::capture (const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    jassert (canFade (numSamples) && numChannels <= dry.getNumChannels());
+    delay (channels, dry.getArrayOfWritePointers(), numChannels, numSamples);
+}
+
+void BypassCrossfade::passThrough (float* const* channels, int numChannels, int numSamples) noexcept
+{
+    delay (channels, channels, numChannels, numSamples);
+}
+
+void BypassCrossfade::delay (const float* const* source, float* const* dest, int numChannels, int numSamples) noexcept
+{
+    const auto length = delayLine.getNumSamples();
+    numChannels = juce::jmin (numChannels, dry.getNumChannels());
+
+    if (length == 0)
+    {
+        if (source != dest)
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::copy (dest[ch], source[ch], numSamples);
+
+        return;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* line = delayLine.getWritePointer (ch);
+        auto position = delayPosition;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto input = source[ch][i];
+            dest[ch][i] = line[position];
+            line[position] = input;
+
+            if (++position == length)
+                position = 0;
+        }
+    }
+
+    delayPosition = (delayPosition + numSamples) % length;
+}
+
+void BypassCrossfade::mix (float* const* channels, int numChannels, int numSamples) noexcept
+{
+    const auto target = bypassed ? 0.0f : 1.0f;
+    numChannels = juce::jmin (numChannels, dry.getNumChannels());
+
+    if (wetGain == target)
+    {
+        if (bypassed)
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::copy (channels[ch], dry.getReadPointer (ch), numSamples);
+
+        return;
+    }
+
+    const auto step = bypassed ? -gainStep : gainStep;
+    auto gain = wetGain;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto* d = dry.getReadPointer (ch);
+        auto* wet = channels[ch];
+        gain = wetGain;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            gain = juce::jlimit (0.0f, 1.0f, gain + step);
+            wet[i] = d[i] + gain * (wet[i] - d[i]);
+        }
+    }
+
+    wetGain = gain;
+}
+
+} // namespace iir
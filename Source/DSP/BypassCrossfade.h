@@ -0,0 +1,76 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace iir
+{
+
+//==============================================================================
+/** Switches between the processed and the dry signal without clicks or a
+    jump in timing.
+
+    The dry signal is delayed by the plug-in's reported latency, so both
+    paths line up, and every switch is a linear crossfade over fadeSeconds.
+    Once a fade into bypass has finished, the processed path isn't needed
+    any more: isFullyBypassed() tells the caller it can skip it, or keep
+    running it on the side so the filters stay warm.
+
+    Call capture() with the input before processing it in place, then mix()
+    with the result. While fully bypassed, passThrough() alone produces the
+    output.
+*/
+class BypassCrossfade
+{
+public:
+    BypassCrossfade() = default;
+
+    static constexpr double fadeSeconds = 0.005;
+
+    /** Allocates the dry and delay buffers. Not real-time safe. */
+    void prepare (double sampleRate, int maxBlockSize, int numChannels, int latencySamples);
+
+    /** Sets whether the coming blocks are bypassed. Returns true if the
+        processed path was fully bypassed until now and is about to be heard
+        again, which is when its state should be cleared if it wasn't kept
+        warm.
+    */
+    bool setBypassed (bool shouldBeBypassed) noexcept;
+
+    bool isFullyBypassed() const noexcept  { return bypassed && wetGain == 0.0f; }
+
+    /** False only while the processed signal is heard alone and there is no
+        latency to keep the delay line fed for, when capture() and mix() can
+        both be skipped.
+    */
+    bool needsDry() const noexcept  { return bypassed || wetGain != 1.0f || delayLine.getNumSamples() > 0; }
+
+    /** True if blocks of this length fit the buffers. Longer blocks than the
+        host announced switch straight to the target instead of fading.
+    */
+    bool canFade (int numSamples) const noexcept  { return numSamples <= dry.getNumSamples(); }
+
+    /** Copies the input, delayed by the latency, as the dry signal. */
+    void capture (const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** Crossfades the processed signal in channels with the captured dry one. */
+    void mix (float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** Delays the channels in place by the latency; nothing to do without any. */
+    void passThrough (float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** Jumps to the target without fading, and clears the delay. */
+    void reset() noexcept;
+
+private:
+    //==============================================================================
+    void delay (const float* const* source, float* const* dest, int numChannels, int numSamples) noexcept;
+
+    juce::AudioBuffer<float> dry, delayLine;
+    int delayPosition = 0;
+    float wetGain = 1.0f, gainStep = 1.0f;
+    bool bypassed = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BypassCrossfade)
+};
+
+} // namespace iir
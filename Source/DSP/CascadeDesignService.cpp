@@ -0,0 +1,149 @@
+#include "CascadeDesignService.h"
+
+namespace iir
+{
+
+//==============================================================================
+CascadeDesignService::CascadeDesignService()
+    : juce::Thread ("IIRFilters cascade designer")
+{
+}
+
+CascadeDesignService::~CascadeDesignService()
+{
+    stopThread (1000);
+}
+
+void CascadeDesignService::start()
+{
+    if (! isThreadRunning())
+        startThread (juce::Thread::Priority::low);
+}
+
+//==============================================================================
+bool CascadeDesignService::request (int slot, const CascadeSpec& spec) noexcept
+{
+    jassert (juce::isPositiveAndBelow (slot, numSlots));
+    auto& s = slots[(size_t) slot];
+
+    int start1, size1, start2, size2;
+    s.mailbox.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return false;
+
+    s.requests[(size_t) (size1 > 0 ? start1 : start2)] = spec;
+    s.mailbox.finishedWrite (1);
+
+    // Only wake the designer when it has gone to sleep, so a burst of
+    // requests signals it once rather than once per request
+    if (sleeping.exchange (false))
+        notify();
+
+    return true;
+}
+
+const CascadeDesign* CascadeDesignService::acquire (int slot) noexcept
+{
+    jassert (juce::isPositiveAndBelow (slot, numSlots));
+    auto& s = slots[(size_t) slot];
+
+    // Publish the hazard, then check it is still current: once that holds,
+    // the designer thread is guaranteed to see it before freeing anything
+    for (;;)
+    {
+        auto* design = s.published.load();
+        s.hazard.store (design);
+
+        if (s.published.load() == design)
+            return design;
+    }
+}
+
+//==============================================================================
+void CascadeDesignService::run()
+{
+    while (! threadShouldExit())
+    {
+        auto anyPublished = false;
+
+        for (auto& s : slots)
+        {
+            int start1, size1, start2, size2;
+            s.mailbox.prepareToRead (s.mailbox.getNumReady(), start1, size1, start2, size2);
+
+            if (size1 + size2 == 0)
+                continue;
+
+            // Only the newest request matters
+            const auto spec = s.requests[(size_t) (size2 > 0 ? start2 + size2 - 1 : start1 + size1 - 1)];
+            s.mailbox.finishedRead (size1 + size2);
+
+            s.published.store (findOrDesign (spec));
+            anyPublished = true;
+        }
+
+        if (anyPublished)
+            evictUnused();
+
+        // Announce the sleep before the last look at the mailboxes: a request
+        // written after that look sees the flag and notifies, and a notify
+        // that lands before wait() isn't lost, as the event stays signalled
+        sleeping.store (true);
+
+        if (! hasPendingRequests())
+            wait (-1);
+
+        sleeping.store (false);
+    }
+}
+
+bool CascadeDesignService::hasPendingRequests() const noexcept
+{
+    return std::any_of (slots.begin(), slots.end(), [] (const Slot& s) { return s.mailbox.getNumReady() > 0; });
+}
+
+const CascadeDesign* CascadeDesignService::findOrDesign (const CascadeSpec& spec)
+{
+    auto existing = std::find_if (cache.begin(), cache.end(),
+                                  [&] (const auto& d) { return d->spec == spec; });
+
+    if (existing != cache.end())
+    {
+        // Move to the back, so the front holds the least recently used designs
+        std::rotate (existing, existing + 1, cache.end());
+        return cache.back().get();
+    }
+
+    auto design = sharedCache->find (spec);
+
+    if (design == nullptr)
+        design = sharedCache->insert (std::make_shared<const CascadeDesign> (CascadeDesigner::design (spec)));
+
+    cache.push_back (std::move (design));
+    numCached.store ((int) cache.size());
+    return cache.back().get();
+}
+
+bool CascadeDesignService::isInUse (const CascadeDesign* design) const noexcept
+{
+    return std::any_of (slots.begin(), slots.end(), [design] (const Slot& s)
+    {
+        return s.published.load() == design || s.hazard.load() == design;
+    });
+}
+
+void CascadeDesignService::evictUnused()
+{
+    for (auto it = cache.begin(); cache.size() > maxCachedDesigns && it != cache.end();)
+    {
+        if (isInUse (it->get()))
+            ++it;
+        else
+            it = cache.erase (it);
+    }
+
+    numCached.store ((int) cache.size());
+}
+
+} // namespace iir
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "SharedDesignCache.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** Runs CascadeDesigner on a background thread and hands the results to the
+    audio thread without locks.
+
+    The audio thread posts specs with request() and picks up finished designs
+    with acquire(). Designs are cached by spec, so going back to a previous
+    setting (or automating between a few) doesn't redesign anything. Behind
+    the per-instance cache sits a SharedDesignCache, so a spec that another
+    instance in the process has already designed is picked up from there.
+
+    A pointer returned by acquire() is protected by a hazard pointer: it stays
+    valid until the next acquire() for the same slot.
+*/
+class CascadeDesignService final : private juce::Thread
+{
+public:
+    CascadeDesignService();
+    ~CascadeDesignService() override;
+
+    static constexpr int numSlots = numCutSlots;
+
+    /** Starts the designer thread. Call from prepareToPlay(). */
+    void start();
+
+    /** Audio thread: asks for a design. Never blocks; if the request mailbox is
+        full the request is dropped and should simply be repeated next block.
+        The designer thread sleeps until a request arrives, and is only
+        signalled when it is actually asleep.
+    */
+    bool request (int slot, const CascadeSpec& spec) noexcept;
+
+    /** Audio thread: the most recent finished design for the slot, or nullptr. */
+    const CascadeDesign* acquire (int slot) noexcept;
+
+    /** Number of designs currently held in this instance's cache. */
+    int getNumCachedDesigns() const noexcept  { return numCached.load(); }
+
+    /** Number of designs alive across all instances in the process. */
+    int getNumSharedDesigns() const  { return sharedCache->getNumDesigns(); }
+
+private:
+    //==============================================================================
+    struct Slot
+    {
+        Slot() = default;
+
+        juce::AbstractFifo mailbox { 8 };
+        std::array<CascadeSpec, 8> requests;
+        std::atomic<const CascadeDesign*> published { nullptr };
+        std::atomic<const CascadeDesign*> hazard { nullptr };
+    };
+
+    void run() override;
+    bool hasPendingRequests() const noexcept;
+    const CascadeDesign* findOrDesign (const CascadeSpec& spec);
+    void evictUnused();
+    bool isInUse (const CascadeDesign* design) const noexcept;
+
+    static constexpr size_t maxCachedDesigns = 32;
+
+    std::array<Slot, numSlots> slots;
+    std::vector<SharedDesignCache::DesignPtr> cache;   // designer thread only, most recent last
+    std::atomic<int> numCached { 0 };
+    std::atomic<bool> sleeping { false };
+    juce::SharedResourcePointer<SharedDesignCache> sharedCache;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CascadeDesignService)
+};
+
+} // namespace iir
@@ -0,0 +1,369 @@
+#include "CascadeDesigner.h"
+#include "DesignTables.h"
+
+#include <complex>
+
+namespace iir
+{
+
+using Complex = std::complex<double>;
+
+//==============================================================================
+CascadeSpec CascadeSpec::fromSettings (const CutSettings& cut, bool highPass, double sampleRate) noexcept
+{
+    CascadeSpec spec;
+    spec.family = cut.family;
+    spec.highPass = highPass;
+    spec.order = juce::jlimit (1, maxCutOrder, cut.order);
+    spec.frequency = cut.frequency;
+    spec.rippleDb = cut.rippleDb;
+    spec.attenuationDb = cut.attenuationDb;
+    spec.sampleRate = sampleRate;
+    return spec;
+}
+
+namespace
+{
+    /** An analog lowpass prototype with its passband edge at 1 rad/s. */
+    struct Prototype
+    {
+        std::vector<Complex> poles, zeros;
+        double dcGain = 1.0;
+    };
+
+    constexpr auto pi = juce::MathConstants<double>::pi;
+
+    //==============================================================================
+    Prototype makeButterworth (int order)
+    {
+        Prototype p;
+
+        for (int k = 1; k <= order; ++k)
+            p.poles.push_back (std::polar (1.0, pi * (2 * k + order - 1) / (2 * order)));
+
+        return p;
+    }
+
+    Prototype makeChebyshev (int order, double rippleDb)
+    {
+        const auto eps = std::sqrt (std::pow (10.0, rippleDb / 10.0) - 1.0);
+        const auto v0 = std::asinh (1.0 / eps) / order;
+
+        Prototype p;
+
+        for (int k = 1; k <= order; ++k)
+        {
+            const auto theta = pi * (2 * k - 1) / (2 * order);
+            p.poles.emplace_back (-std::sinh (v0) * std::sin (theta), std::cosh (v0) * std::cos (theta));
+        }
+
+        p.dcGain = (order % 2 != 0) ? 1.0 : 1.0 / std::sqrt (1.0 + eps * eps);
+        return p;
+    }
+
+    //==============================================================================
+    // Jacobi elliptic functions via descending Landen transformations, after
+    // S. J. Orfanidis, "Lecture Notes on Elliptic Filter Design". Arguments are
+    // normalised to the quarter period, i.e. cde (u, k) = cd (u K (k), k).
+    constexpr int numLandenSteps = 7;
+
+    std::array<double, numLandenSteps> landen (double k)
+    {
+        std::array<double, numLandenSteps> v;
+
+        for (auto& vn : v)
+        {
+            k = juce::square (k / (1.0 + std::sqrt (1.0 - k * k)));
+            vn = k;
+        }
+
+        return v;
+    }
+
+    Complex landenAscend (Complex w, double k)
+    {
+        const auto v = landen (k);
+
+        for (auto n = numLandenSteps; --n >= 0;)
+            w = (1.0 + v[(size_t) n]) * w / (1.0 + v[(size_t) n] * w * w);
+
+        return w;
+    }
+
+    Complex cde (Complex u, double k)  { return landenAscend (std::cos (u * pi * 0.5), k); }
+    Complex sne (Complex u, double k)  { return landenAscend (std::sin (u * pi * 0.5), k); }
+
+    Complex asne (Complex w, double k)
+    {
+        const auto v = landen (k);
+
+        for (int n = 0; n < numLandenSteps; ++n)
+        {
+            const auto previous = n == 0 ? k : v[(size_t) n - 1];
+            w = w / (1.0 + std::sqrt (1.0 - w * w * previous * previous)) * 2.0 / (1.0 + v[(size_t) n]);
+        }
+
+        return std::asin (w) * 2.0 / pi;
+    }
+
+    double ellipticK (double k)
+    {
+        // Arithmetic-geometric mean
+        auto a = 1.0, b = std::sqrt (1.0 - k * k);
+
+        for (int i = 0; i < 32 && std::abs (a - b) > 1.0e-15 * a; ++i)
+        {
+            const auto next = (a + b) * 0.5;
+            b = std::sqrt (a * b);
+            a = next;
+        }
+
+        return pi / (2.0 * a);
+    }
+
+    /** Solves the degree equation for the selectivity k, given N and k1. */
+    double ellipticDegree (int order, double k1)
+    {
+        const auto q1 = std::exp (-pi * ellipticK (std::sqrt (1.0 - k1 * k1)) / ellipticK (k1));
+        const auto q = std::pow (q1, 1.0 / order);
+
+        auto numerator = 0.0, denominator = 1.0;
+
+        for (int m = 0; m <= 7; ++m)
+            numerator += std::pow (q, m * (m + 1));
+
+        for (int m = 1; m <= 7; ++m)
+            denominator += 2.0 * std::pow (q, m * m);
+
+        return 4.0 * std::sqrt (q) * juce::square (numerator / denominator);
+    }
+
+    Prototype makeElliptic (int order, double rippleDb, double attenuationDb)
+    {
+        const auto ep = std::sqrt (std::pow (10.0, rippleDb / 10.0) - 1.0);
+        const auto es = std::sqrt (std::pow (10.0, attenuationDb / 10.0) - 1.0);
+        const auto k1 = ep / es;
+        const auto k = ellipticDegree (order, k1);
+        const auto j = Complex (0.0, 1.0);
+
+        const auto v0 = -j * asne (j / ep, k1) / (double) order;
+
+        Prototype p;
+
+        for (int i = 1; i <= order / 2; ++i)
+        {
+            const auto u = (2.0 * i - 1.0) / order;
+            const auto zero = j / (k * cde (u, k));
+            const auto pole = j * cde (u - j * v0, k);
+
+            p.zeros.push_back (zero);
+            p.zeros.push_back (std::conj (zero));
+            p.poles.push_back (pole);
+            p.poles.push_back (std::conj (pole));
+        }
+
+        if (order % 2 != 0)
+            p.poles.emplace_back ((j * sne (j * v0, k)).real(), 0.0);
+
+        p.dcGain = (order % 2 != 0) ? 1.0 : 1.0 / std::sqrt (1.0 + ep * ep);
+        return p;
+    }
+
+    //==============================================================================
+    bool isReal (Complex c) noexcept  { return std::abs (c.imag()) < 1.0e-12; }
+
+    /** Splits roots into one representative per conjugate pair and the real roots. */
+    void splitConjugates (const std::vector<Complex>& roots, std::vector<Complex>& pairs, std::vector<double>& reals)
+    {
+        for (auto r : roots)
+        {
+            if (isReal (r))
+                reals.push_back (r.real());
+            else if (r.imag() > 0.0)
+                pairs.push_back (r);
+        }
+    }
+
+    template <typename Container, typename Distance>
+    size_t findNearest (const Container& c, Distance&& distance)
+    {
+        size_t best = 0;
+
+        for (size_t i = 1; i < c.size(); ++i)
+            if (distance (c[i]) < distance (c[best]))
+                best = i;
+
+        return best;
+    }
+
+    double magnitudeAt (const BiquadCoefficients<double>& s, double w)
+    {
+        const auto z1 = std::polar (1.0, -w);
+        const auto z2 = z1 * z1;
+        return std::abs ((s.b0 + s.b1 * z1 + s.b2 * z2) / (1.0 + s.a1 * z1 + s.a2 * z2));
+    }
+}
+
+//==============================================================================
+CascadeDesign CascadeDesigner::design (const CascadeSpec& spec)
+{
+    jassert (spec.sampleRate > 0.0);
+
+    const auto order = juce::jlimit (1, maxCutOrder, spec.order);
+    const auto rippleDb = juce::jmax (1.0e-3, spec.rippleDb);
+    const auto attenuationDb = juce::jmax (rippleDb + 1.0, spec.attenuationDb);
+
+    const auto prototype = [&]
+    {
+        switch (spec.family)
+        {
+            case PrototypeFamily::chebyshev:  return makeChebyshev (order, rippleDb);
+            case PrototypeFamily::elliptic:   return makeElliptic (order, rippleDb, attenuationDb);
+            case PrototypeFamily::butterworth: break;
+        }
+
+        return makeButterworth (order);
+    }();
+
+    // Prewarped bilinear transform, z = (1 + s) / (1 - s), with the band edge at tan (w / 2)
+    const auto frequency = juce::jlimit (1.0, spec.sampleRate * 0.49, spec.frequency);
+    const auto warped = DesignTables::getWarpedFrequency (frequency, spec.sampleRate);
+
+    auto toDigital = [&] (Complex s)
+    {
+        s = spec.highPass ? warped / s : warped * s;
+        return (1.0 + s) / (1.0 - s);
+    };
+
+    std::vector<Complex> poles, zeros;
+
+    for (auto p : prototype.poles)  poles.push_back (toDigital (p));
+    for (auto z : prototype.zeros)  zeros.push_back (toDigital (z));
+
+    // Zeros at infinity end up at Nyquist for a lowpass and at DC for a highpass
+    while (zeros.size() < poles.size())
+        zeros.emplace_back (spec.highPass ? 1.0 : -1.0, 0.0);
+
+    std::vector<Complex> polePairs, zeroPairs;
+    std::vector<double> realPoles, realZeros;
+    splitConjugates (poles, polePairs, realPoles);
+    splitConjugates (zeros, zeroPairs, realZeros);
+
+    // Pair from the most resonant pole inwards, so the critical poles get the
+    // zeros that tame them best
+    std::sort (polePairs.begin(), polePairs.end(),
+               [] (Complex a, Complex b) { return std::abs (a) > std::abs (b); });
+
+    struct Section
+    {
+        BiquadCoefficients<double> coefficients;
+        double radius;
+    };
+
+    std::vector<Section> sections;
+
+    auto takeRealZero = [&] (double nearTo)
+    {
+        jassert (! realZeros.empty());
+        const auto index = findNearest (realZeros, [=] (double z) { return std::abs (z - nearTo); });
+        const auto z = realZeros[index];
+        realZeros.erase (realZeros.begin() + (std::ptrdiff_t) index);
+        return z;
+    };
+
+    for (auto p : polePairs)
+    {
+        BiquadCoefficients<double> c;
+        c.a1 = -2.0 * p.real();
+        c.a2 = std::norm (p);
+
+        if (! zeroPairs.empty())
+        {
+            const auto index = findNearest (zeroPairs, [=] (Complex z) { return std::abs (z - p); });
+            const auto z = zeroPairs[index];
+            zeroPairs.erase (zeroPairs.begin() + (std::ptrdiff_t) index);
+
+            c.b1 = -2.0 * z.real();
+            c.b2 = std::norm (z);
+        }
+        else
+        {
+            const auto z1 = takeRealZero (p.real());
+            const auto z2 = takeRealZero (p.real());
+
+            c.b1 = -(z1 + z2);
+            c.b2 = z1 * z2;
+        }
+
+        sections.push_back ({ c, std::abs (p) });
+    }
+
+    for (auto p : realPoles)
+    {
+        BiquadCoefficients<double> c;
+        c.a1 = -p;
+        c.b1 = -takeRealZero (p);
+        sections.push_back ({ c, std::abs (p) });
+    }
+
+    jassert (realZeros.empty() && zeroPairs.empty());
+
+    std::stable_sort (sections.begin(), sections.end(),
+                      [] (const Section& a, const Section& b) { return a.radius < b.radius; });
+
+    CascadeDesign result;
+    result.spec = spec;
+
+    for (auto& s : sections)
+        result.sections.push_back (s.coefficients);
+
+    // Overall gain: match the prototype's DC gain in the passband
+    const auto referenceW = spec.highPass ? pi : 0.0;
+    auto unscaledGain = 1.0;
+
+    for (auto& s : result.sections)
+        unscaledGain *= magnitudeAt (s, referenceW);
+
+    const auto totalGain = prototype.dcGain / unscaledGain;
+
+    // Grid for the peak search: log-spaced from 5 Hz to Nyquist, plus every pole angle
+    std::vector<double> grid;
+    const auto lowest = juce::MathConstants<double>::twoPi * 5.0 / spec.sampleRate;
+
+    for (int i = 0; i <= 512; ++i)
+        grid.push_back (lowest * std::pow (pi / lowest, i / 512.0));
+
+    for (auto p : polePairs)
+        grid.push_back (std::arg (p));
+
+    std::vector<double> running (grid.size(), 1.0);
+    auto appliedGain = 1.0;
+
+    for (size_t i = 0; i + 1 < result.sections.size(); ++i)
+    {
+        auto& s = result.sections[i];
+        auto peak = 0.0;
+
+        for (size_t g = 0; g < grid.size(); ++g)
+        {
+            running[g] *= magnitudeAt (s, grid[g]);
+            peak = juce::jmax (peak, running[g]);
+        }
+
+        const auto gain = 1.0 / peak;
+
+        for (auto& r : running)
+            r *= gain;
+
+        s.b0 *= gain;  s.b1 *= gain;  s.b2 *= gain;
+        appliedGain *= gain;
+    }
+
+    auto& last = result.sections.back();
+    const auto lastGain = totalGain / appliedGain;
+    last.b0 *= lastGain;  last.b1 *= lastGain;  last.b2 *= lastGain;
+
+    return result;
+}
+
+} // namespace iir
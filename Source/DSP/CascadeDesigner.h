@@ -0,0 +1,66 @@
+#pragma once
+
+#include "BiquadCoefficients.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** What to design: a digital low or high cut from an analog prototype. */
+struct CascadeSpec
+{
+    PrototypeFamily family = PrototypeFamily::butterworth;
+    bool highPass = false;
+    int order = 2;
+    double frequency = 1000.0;
+    double rippleDb = 0.5;
+    double attenuationDb = 60.0;
+    double sampleRate = 44100.0;
+
+    static CascadeSpec fromSettings (const CutSettings& cut, bool highPass, double sampleRate) noexcept;
+
+    bool operator== (const CascadeSpec& other) const noexcept
+    {
+        return family == other.family
+            && highPass == other.highPass
+            && order == other.order
+            && frequency == other.frequency
+            && rippleDb == other.rippleDb
+            && attenuationDb == other.attenuationDb
+            && sampleRate == other.sampleRate;
+    }
+
+    bool operator!= (const CascadeSpec& other) const noexcept  { return ! operator== (other); }
+};
+
+constexpr int maxCascadeSections = (maxCutOrder + 1) / 2;
+
+/** A finished design. Sections are in processing order; an odd order ends up
+    with one first-order section (b2 == a2 == 0).
+*/
+struct CascadeDesign
+{
+    CascadeSpec spec;
+    std::vector<BiquadCoefficients<double>> sections;
+};
+
+//==============================================================================
+/** Turns analog prototypes of order 1 to maxCutOrder into cascades of
+    second-order sections.
+
+    - Poles and zeros are mapped with a prewarped bilinear transform.
+    - Each pole pair, starting with the one closest to the unit circle, gets
+      the nearest remaining zeros.
+    - Sections run from the lowest to the highest pole radius.
+    - The overall gain is spread so that the running product of the sections
+      peaks at exactly 1 after every section but the last. No intermediate
+      point in the cascade can then gain headroom over the input.
+
+    This allocates and is far too slow for the audio thread.
+*/
+namespace CascadeDesigner
+{
+    CascadeDesign design (const CascadeSpec& spec);
+}
+
+} // namespace iir
@@ -0,0 +1,222 @@
+#include "Crossover.h"
+#include "BiquadCoefficients.h"
+
+namespace iir
+{
+
+/** The cookbook allpass: unit magnitude, with the phase turning through
+    -2 pi around frequency, as fast as the Q says.
+*/
+static BiquadCoefficients<double> designAllpass (double frequency, double q, double sampleRate) noexcept
+{
+    frequency = juce::jlimit (1.0, sampleRate * 0.49, frequency);
+
+    const auto w0    = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    const auto cosw0 = std::cos (w0);
+    const auto alpha = std::sin (w0) / (2.0 * q);
+    const auto a0    = 1.0 + alpha;
+
+    BiquadCoefficients<double> c;
+    c.b0 = (1.0 - alpha) / a0;
+    c.b1 = -2.0 * cosw0 / a0;
+    c.b2 = 1.0;
+    c.a1 = c.b1;
+    c.a2 = c.b0;
+    return c;
+}
+
+//==============================================================================
+void Crossover::prepare (double newSampleRate, int newNumChannels)
+{
+    jassert (newSampleRate > 0.0);
+
+    sampleRate = newSampleRate;
+    numChannels = juce::jmax (0, newNumChannels);
+    numPairs = (numChannels + 1) / 2;
+
+    const auto numStates = (size_t) numPairs * maxSections;
+    arena.allocate (Arena::getBytesFor<State> (numStates));
+    states = arena.take<State> (numStates);
+
+    design();
+}
+
+void Crossover::release() noexcept
+{
+    arena.release();
+    states = nullptr;
+    numChannels = 0;
+    numPairs = 0;
+}
+
+void Crossover::reset() noexcept
+{
+    for (int i = 0; i < numPairs * maxSections; ++i)
+        states[i].reset();
+}
+
+void Crossover::setSettings (const CrossoverSettings& newSettings) noexcept
+{
+    if (newSettings == settings)
+        return;
+
+    const auto restart = (newSettings.enabled && ! settings.enabled)
+                      || newSettings.numBands != settings.numBands
+                      || newSettings.slope != settings.slope;
+
+    settings = newSettings;
+    settings.numBands = juce::jlimit (2, maxCrossoverBands, settings.numBands);
+    design();
+
+    if (restart)
+        reset();
+}
+
+void Crossover::design() noexcept
+{
+    // An LR4 side is a second-order Butterworth section twice, an LR8 side a
+    // fourth-order Butterworth filter twice; either way both sides sum to the
+    // allpass with the Butterworth poles, which takes one section per Q
+    static constexpr double butterworthQs[][2] = { { 0.70710678118654752, 0.0 },
+                                                   { 0.54119610014619698, 1.30656296487637653 } };
+
+    const auto lr8 = settings.slope == CrossoverSlope::lr8;
+    const auto numQs = lr8 ? 2 : 1;
+    const auto sectionsPerSplit = 2 * numQs;
+    const auto numSplits = settings.numBands - 1;
+    numSections = numSplits * sectionsPerSplit;
+
+    // Splits only make sense in order, whatever order the frequencies were set in
+    auto frequencies = settings.frequencies;
+
+    for (int i = 1; i < numSplits; ++i)
+        for (auto j = (size_t) i; j > 0 && frequencies[j] < frequencies[j - 1]; --j)
+            std::swap (frequencies[j], frequencies[j - 1]);
+
+    tailSamples = 0.0;
+
+    for (int split = 0; split < numSplits; ++split)
+    {
+        const auto frequency = (double) frequencies[(size_t) split];
+
+        for (int i = 0; i < sectionsPerSplit; ++i)
+        {
+            auto& section = sections[(size_t) (split * sectionsPerSplit + i)];
+            const auto q = butterworthQs[lr8 ? 1 : 0][i % numQs];
+            auto sectionTail = 0.0;
+
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                const auto band = lane % maxCrossoverBands;
+                BiquadCoefficients<double> c;
+
+                if (band < split)
+                {
+                    // Below this split: its allpass, padded with pass-through sections
+                    if (i < numQs)
+                        c = designAllpass (frequency, q, sampleRate);
+                }
+                else if (band < settings.numBands)
+                {
+                    BandSettings side;
+                    side.type = band == split ? FilterType::lowPass : FilterType::highPass;
+                    side.frequency = (float) frequency;
+                    side.q = (float) q;
+                    c = BiquadCoefficients<double>::design (side, sampleRate);
+                }
+
+                section.b0[(size_t) lane] = (float) c.b0;
+                section.b1[(size_t) lane] = (float) c.b1;
+                section.b2[(size_t) lane] = (float) c.b2;
+                section.a1[(size_t) lane] = (float) c.a1;
+                section.a2[(size_t) lane] = (float) c.a2;
+                sectionTail = juce::jmax (sectionTail, c.getDecaySamples());
+            }
+
+            tailSamples += sectionTail;
+        }
+    }
+}
+
+//==============================================================================
+void Crossover::process (const float* const* channels, int numChannelsToProcess, int numSamples,
+                         float* const* const* bands) noexcept
+{
+    if (! settings.enabled)
+        return;
+
+    jassert (numChannelsToProcess <= numChannels);
+    numChannelsToProcess = juce::jmin (numChannelsToProcess, numChannels);
+
+    for (int pair = 0; pair * 2 < numChannelsToProcess; ++pair)
+    {
+        auto* pairStates = states + pair * maxSections;
+        const auto firstChannel = pair * 2;
+        const auto numPairChannels = juce::jmin (2, numChannelsToProcess - firstChannel);
+
+        for (int start = 0; start < numSamples; start += maxFrames)
+        {
+            const auto n = juce::jmin (maxFrames, numSamples - start);
+
+            for (int half = 0; half < 2; ++half)
+            {
+                const auto* src = half < numPairChannels ? channels[firstChannel + half] + start : nullptr;
+                const auto firstLane = (size_t) (half * maxCrossoverBands);
+
+                for (int i = 0; i < n; ++i)
+                {
+                    auto& frame = frames[(size_t) i];
+                    const auto x = src != nullptr ? src[i] : 0.0f;
+
+                    for (size_t band = 0; band < (size_t) maxCrossoverBands; ++band)
+                        frame[firstLane + band] = x;
+                }
+            }
+
+            for (int s = 0; s < numSections; ++s)
+                processSection (sections[(size_t) s], pairStates[s], frames.data(), n);
+
+            for (int band = 0; band < settings.numBands; ++band)
+            {
+                if (bands[band] == nullptr)
+                    continue;
+
+                for (int half = 0; half < numPairChannels; ++half)
+                {
+                    auto* dest = bands[band][firstChannel + half] + start;
+                    const auto lane = (size_t) (half * maxCrossoverBands + band);
+
+                    for (int i = 0; i < n; ++i)
+                        dest[i] = frames[(size_t) i][lane];
+                }
+            }
+        }
+    }
+}
+
+void Crossover::processSection (const Section& section, State& state, Frame* frameData, int numFrames) noexcept
+{
+    // Local copies keep the coefficients and state in registers: the frames
+    // are floats too, so the compiler can't assume stores to them leave these alone
+    const auto b0 = section.b0, b1 = section.b1, b2 = section.b2, a1 = section.a1, a2 = section.a2;
+    auto z1 = state.z1, z2 = state.z2;
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        auto& frame = frameData[i];
+
+        for (size_t lane = 0; lane < (size_t) lanes; ++lane)
+        {
+            const auto x = frame[lane];
+            const auto y = b0[lane] * x + z1[lane];
+            z1[lane] = b1[lane] * x - a1[lane] * y + z2[lane];
+            z2[lane] = b2[lane] * x - a2[lane] * y;
+            frame[lane] = y;
+        }
+    }
+
+    state.z1 = z1;
+    state.z2 = z2;
+}
+
+} // namespace iir
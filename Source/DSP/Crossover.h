@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Arena.h"
+#include "FilterSettings.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** A Linkwitz-Riley crossover that splits each channel into up to
+    maxCrossoverBands bands.
+
+    Band k is the input through the high-pass side of every split below it,
+    the low-pass side of split k and the allpass that the two sides of every
+    split above it sum to. Every band therefore has the same phase response,
+    that of all the allpasses together, and the bands sum to it with a flat
+    magnitude.
+
+    Written that way, every band runs the same number of sections, one stage
+    per split, and only the coefficients differ from band to band. So instead
+    of a tree of splits, each band is one lane of a vector fed the same input:
+    one pass over the sections computes all the bands of a channel at once. An
+    allpass stage needs fewer sections than a low- or high-pass one and is
+    padded out with pass-through sections.
+
+    The channels go through in pairs, two sets of bands side by side. Each
+    section's recursion has to wait for its previous output, and a second
+    channel gives the core independent work to do in the meantime.
+*/
+class Crossover
+{
+public:
+    Crossover() = default;
+
+    /** Allocates state for the given layout. Not real-time safe. */
+    void prepare (double newSampleRate, int numChannels);
+
+    /** Frees the state. Until the next prepare(), process() does nothing. */
+    void release() noexcept;
+
+    void reset() noexcept;
+
+    /** Redesigns the splits. Changing the number of bands or the slope starts
+        the bands from silence; moving a frequency doesn't.
+    */
+    void setSettings (const CrossoverSettings& newSettings) noexcept;
+
+    int getNumBands() const noexcept  { return settings.enabled ? settings.numBands : 0; }
+
+    /** How long the bands keep ringing once the input stops, in samples: the
+        sum over the sections of the slowest lane's decay time.
+    */
+    double getTailSamples() const noexcept  { return settings.enabled ? tailSamples : 0.0; }
+
+    /** Splits the channels into getNumBands() bands, leaving the input as it
+        is. bands[band][channel] receives the samples of a band; a band whose
+        entry is nullptr is skipped.
+    */
+    void process (const float* const* channels, int numChannels, int numSamples,
+                  float* const* const* bands) noexcept;
+
+private:
+    //==============================================================================
+    static constexpr int lanes = 2 * maxCrossoverBands;   // the bands of a pair of channels
+    static constexpr int maxSectionsPerSplit = 4;
+    static constexpr int maxSections = (maxCrossoverBands - 1) * maxSectionsPerSplit;
+    static constexpr int maxFrames = 256;
+
+    using Frame = std::array<float, lanes>;
+
+    // Transposed direct form II, with one row of each coefficient across the lanes
+    struct Section
+    {
+        alignas (64) Frame b0, b1, b2, a1, a2;
+    };
+
+    struct State
+    {
+        alignas (64) Frame z1, z2;
+
+        void reset() noexcept  { z1 = {}; z2 = {}; }
+    };
+
+    void design() noexcept;
+    static void processSection (const Section& section, State& state, Frame* frameData, int numFrames) noexcept;
+
+    //==============================================================================
+    double sampleRate = 44100.0;
+    CrossoverSettings settings;
+    int numSections = 0;
+    double tailSamples = 0.0;
+    std::array<Section, maxSections> sections;
+    alignas (64) std::array<Frame, maxFrames> frames;
+    Arena arena;
+    State* states = nullptr;   // [pair][section]
+    int numChannels = 0, numPairs = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Crossover)
+};
+
+} // namespace iir
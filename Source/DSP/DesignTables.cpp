@@ -0,0 +1,138 @@
+#include "DesignTables.h"
+
+namespace iir
+{
+namespace DesignTables
+{
+
+namespace
+{
+    constexpr int numRates = (int) standardSampleRates.size();
+
+    constexpr int minTabledDb = -48, maxTabledDb = 48;
+
+    constexpr std::array<double, 31> thirdOctaveFrequencies
+    {
+        20.0, 25.0, 31.5, 40.0, 50.0, 63.0, 80.0, 100.0, 125.0, 160.0, 200.0, 250.0, 315.0, 400.0, 500.0, 630.0,
+        800.0, 1000.0, 1250.0, 1600.0, 2000.0, 2500.0, 3150.0, 4000.0, 5000.0, 6300.0, 8000.0, 10000.0,
+        12500.0, 16000.0, 20000.0
+    };
+
+    constexpr int numFrequencies = (int) thirdOctaveFrequencies.size();
+
+    template <size_t N>
+    constexpr int find (const std::array<double, N>& values, double value) noexcept
+    {
+        for (size_t i = 0; i < N; ++i)
+            if (values[i] == value)
+                return (int) i;
+
+        return -1;
+    }
+
+    //==============================================================================
+    // Built once when the library is loaded. Working them out at compile time
+    // takes series expansions that exceed the constant-evaluation limits of
+    // clang and MSVC, for tables that take well under a millisecond here
+    const auto amplitudes = []
+    {
+        std::array<double, maxTabledDb - minTabledDb + 1> table {};
+
+        for (int i = 0; i < (int) table.size(); ++i)
+            table[(size_t) i] = std::pow (10.0, (double) (minTabledDb + i) / 40.0);
+
+        return table;
+    }();
+
+    const auto warpedFrequencies = []
+    {
+        std::array<std::array<double, numFrequencies>, numRates> table {};
+
+        for (int r = 0; r < numRates; ++r)
+            for (int f = 0; f < numFrequencies; ++f)
+                table[(size_t) r][(size_t) f] = std::tan (juce::MathConstants<double>::pi * thirdOctaveFrequencies[(size_t) f]
+                                                                                            / standardSampleRates[(size_t) r]);
+
+        return table;
+    }();
+
+    constexpr std::array<int, 2> presetOrders { 2, 4 };
+    constexpr double presetLowCutFrequency = 30.0, presetHighCutFrequency = 18000.0;
+
+    // After warpedFrequencies, which the designer reads
+    const auto presetCascades = []
+    {
+        std::array<PresetCascade, 2 * presetOrders.size() * (size_t) numRates> table {};
+        size_t next = 0;
+
+        for (auto highPass : { true, false })
+        {
+            for (auto order : presetOrders)
+            {
+                for (auto rate : standardSampleRates)
+                {
+                    CascadeSpec spec;
+                    spec.highPass = highPass;
+                    spec.order = order;
+                    spec.frequency = highPass ? presetLowCutFrequency : presetHighCutFrequency;
+                    spec.sampleRate = rate;
+
+                    const auto design = CascadeDesigner::design (spec);
+                    jassert ((int) design.sections.size() <= maxPresetSections);
+
+                    auto& preset = table[next++];
+                    preset.highPass = highPass;
+                    preset.order = order;
+                    preset.frequency = spec.frequency;
+                    preset.sampleRate = rate;
+                    preset.numSections = juce::jmin ((int) design.sections.size(), maxPresetSections);
+                    std::copy_n (design.sections.begin(), preset.numSections, preset.sections.begin());
+                }
+            }
+        }
+
+        return table;
+    }();
+}
+
+//==============================================================================
+double getAmplitude (double gainDb) noexcept
+{
+    const auto whole = (int) gainDb;
+
+    if ((double) whole == gainDb && whole >= minTabledDb && whole <= maxTabledDb)
+        return amplitudes[(size_t) (whole - minTabledDb)];
+
+    return std::pow (10.0, gainDb / 40.0);
+}
+
+double getWarpedFrequency (double frequency, double sampleRate) noexcept
+{
+    const auto rate = find (standardSampleRates, sampleRate);
+
+    if (rate >= 0)
+    {
+        const auto index = find (thirdOctaveFrequencies, frequency);
+
+        if (index >= 0)
+            return warpedFrequencies[(size_t) rate][(size_t) index];
+    }
+
+    return std::tan (juce::MathConstants<double>::pi * frequency / sampleRate);
+}
+
+const PresetCascade* findCascade (const CascadeSpec& spec) noexcept
+{
+    if (spec.family != PrototypeFamily::butterworth)
+        return nullptr;
+
+    for (auto& preset : presetCascades)
+        if (preset.highPass == spec.highPass && preset.order == spec.order
+             && preset.frequency == spec.frequency && preset.sampleRate == spec.sampleRate)
+            return &preset;
+
+    return nullptr;
+}
+
+} // namespace DesignTables
+} // namespace iir
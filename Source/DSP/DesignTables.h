@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CascadeDesigner.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** Design values that are computed once when the library loads rather than
+    every time a plug-in is created or prepared.
+
+    The tables cover what sessions use most: whole-dB gains, the ISO
+    third-octave frequencies and the default cuts, at the standard sample
+    rates. Anything else falls back to computing the value, so the lookups
+    can be used everywhere a design needs one.
+*/
+namespace DesignTables
+{
+    /** The sample rates the tables are built for. */
+    constexpr std::array<double, 6> standardSampleRates { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+
+    /** 10^(gainDb / 40), the amplitude A of the cookbook shelf and peak
+        designs. Tabled for whole dB from -48 to 48.
+    */
+    double getAmplitude (double gainDb) noexcept;
+
+    /** tan (pi * frequency / sampleRate), the bilinear transform's prewarped
+        frequency. Tabled for the ISO third-octave frequencies from 20 Hz to
+        20 kHz at the standard sample rates.
+    */
+    double getWarpedFrequency (double frequency, double sampleRate) noexcept;
+
+    constexpr int maxPresetSections = 2;
+
+    /** A cut cascade designed by CascadeDesigner when the library loads. */
+    struct PresetCascade
+    {
+        bool highPass = false;
+        int order = 0;
+        double frequency = 0.0, sampleRate = 0.0;
+        int numSections = 0;
+        std::array<BiquadCoefficients<double>, maxPresetSections> sections {};
+    };
+
+    /** The ready-made design for a spec, or nullptr. There is one for the
+        Butterworth low cut at 30 Hz and high cut at 18 kHz, the defaults, of
+        order 2 and 4 at each standard sample rate. A cut set to one of these
+        can run from the first block, without waiting for the designer thread.
+    */
+    const PresetCascade* findCascade (const CascadeSpec& spec) noexcept;
+}
+
+} // namespace iir
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "SectionKernels.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** The fixed part of a dynamic band: everything except the gain, which the
+    kernel works out per sample and per lane from the detector.
+*/
+template <typename SampleType>
+struct DynamicBandCoefficients
+{
+    FilterType type = FilterType::peak;
+    SampleType g = 0, k = 1;               // prewarped cutoff and 1 / Q
+    SampleType gainDb = 0;                 // the band's gain before any reduction
+    SvfCoefficients<SampleType> detector;
+    SampleType attack = 0, release = 0;
+    SampleType thresholdDb = 0, slope = 0, rangeDb = 0;
+
+    /** Only bands with a gain can have their gain pulled down. */
+    static constexpr bool supports (FilterType t) noexcept
+    {
+        return t == FilterType::peak || t == FilterType::lowShelf || t == FilterType::highShelf;
+    }
+
+    static DynamicBandCoefficients design (const BandSettings& band, const DynamicsSettings& dynamics,
+                                           double sampleRate) noexcept
+    {
+        jassert (sampleRate > 0.0 && supports (band.type));
+
+        const auto frequency = juce::jlimit (1.0, sampleRate * 0.49, (double) band.frequency);
+        const auto q = juce::jmax (1.0e-3, (double) band.q);
+
+        DynamicBandCoefficients c;
+        c.type = band.type;
+        c.g = (SampleType) DesignTables::getWarpedFrequency (frequency, sampleRate);
+        c.k = (SampleType) (1.0 / q);
+        c.gainDb = (SampleType) band.gainDb;
+
+        // The detector listens where the band acts: around a peak, below a low
+        // shelf and above a high shelf
+        BandSettings detector;
+        detector.type = band.type == FilterType::lowShelf  ? FilterType::lowPass
+                      : band.type == FilterType::highShelf ? FilterType::highPass
+                                                           : FilterType::bandPass;
+        detector.frequency = (float) frequency;
+        detector.q = (float) q;
+        c.detector = SvfCoefficients<SampleType>::design (detector, sampleRate);
+
+        const auto makeCoefficient = [sampleRate] (float timeMs)
+        {
+            const auto samples = (double) timeMs * 0.001 * sampleRate;
+            return samples > 0.0 ? (SampleType) std::exp (-1.0 / samples) : (SampleType) 0;
+        };
+
+        c.attack = makeCoefficient (dynamics.attackMs);
+        c.release = makeCoefficient (dynamics.releaseMs);
+        c.thresholdDb = (SampleType) dynamics.thresholdDb;
+        c.slope = (SampleType) (1.0 - 1.0 / juce::jmax (1.0f, dynamics.ratio));
+        c.rangeDb = (SampleType) dynamics.rangeDb;
+        return c;
+    }
+};
+
+//==============================================================================
+/** A peak or shelf band whose gain follows an IIR envelope detector, run as
+    one pass over frames of Lanes interleaved samples.
+
+    Per sample and per lane, the detector SVF filters the key signal, a
+    one-pole follower tracks its rectified level, the gain computer turns the
+    level in dB into a gain reduction, and a TPT SVF is designed for the
+    resulting gain and run over the audio. Every step is plain arithmetic over
+    the lane arrays, so detector and filter share the same vector registers
+    and the audio is only read and written once.
+
+    The SVF is used whatever the band's topology is set to, because it is the
+    one that stays well behaved under per-sample coefficient changes.
+*/
+template <typename SampleType, int Lanes>
+struct DynamicBandKernel
+{
+    using Coefficients = DynamicBandCoefficients<SampleType>;
+
+    struct State
+    {
+        alignas (64) SampleType z[5][Lanes] {};   // detector ic1, ic2, envelope, filter ic1, ic2
+
+        void reset() noexcept  { *this = {}; }
+    };
+
+    /** Filters data in place. The detector follows sidechain if it isn't
+        nullptr, and the audio itself otherwise; both hold numSamples frames.
+    */
+    static void process (const Coefficients& c, State& s, SampleType* data,
+                         const SampleType* sidechain, int numSamples) noexcept
+    {
+        switch (c.type)
+        {
+            case FilterType::peak:       processType<FilterType::peak>      (c, s, data, sidechain, numSamples); break;
+            case FilterType::lowShelf:   processType<FilterType::lowShelf>  (c, s, data, sidechain, numSamples); break;
+            case FilterType::highShelf:  processType<FilterType::highShelf> (c, s, data, sidechain, numSamples); break;
+
+            case FilterType::lowPass:
+            case FilterType::highPass:
+            case FilterType::bandPass:
+            case FilterType::notch:
+                jassertfalse;
+                break;
+        }
+    }
+
+private:
+    template <FilterType Type>
+    static void processType (const Coefficients& c, State& s, SampleType* data,
+                             const SampleType* sidechain, int numSamples) noexcept
+    {
+        auto local = s;
+        auto& dic1 = local.z[0];
+        auto& dic2 = local.z[1];
+        auto& env  = local.z[2];
+        auto& ic1  = local.z[3];
+        auto& ic2  = local.z[4];
+
+        const auto& d = c.detector;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = data + i * Lanes;
+            const auto* key = sidechain != nullptr ? sidechain + i * Lanes : frame;
+
+            IIR_LANE_LOOP
+            for (int l = 0; l < Lanes; ++l)
+            {
+                // Detector
+                const auto dv3 = key[l] - dic2[l];
+                const auto dv1 = d.a1 * dic1[l] + d.a2 * dv3;
+                const auto dv2 = dic2[l] + d.a2 * dic1[l] + d.a3 * dv3;
+                dic1[l] = 2 * dv1 - dic1[l];
+                dic2[l] = 2 * dv2 - dic2[l];
+
+                // Selects and clamps are written without comparisons: under
+                // strict IEEE flags a compare stops the lane loop vectorising
+                const auto level = std::abs (d.m0 * key[l] + d.m1 * dv1 + d.m2 * dv2);
+                const auto rising = (SampleType) 0.5 + std::copysign ((SampleType) 0.5, level - env[l]);
+                env[l] = level + (c.release + (c.attack - c.release) * rising) * (env[l] - level);
+
+                // Gain computer: 20 log10 (x) = 6.0206 log2 (x), and the
+                // reduction clamped to [0, range] as max (0, x) = (x + |x|) / 2
+                // and min (r, x) = (r + x - |r - x|) / 2
+                const auto levelDb = (SampleType) 6.0206 * FastMath::log2 ((float) env[l] + 1.0e-9f);
+                const auto over = (levelDb - c.thresholdDb) * c.slope;
+                const auto positive = (SampleType) 0.5 * (over + std::abs (over));
+                const auto reduction = (SampleType) 0.5 * (c.rangeDb + positive - std::abs (c.rangeDb - positive));
+                const auto gainDb = c.gainDb - reduction;
+
+                // SVF for that gain, sqrt (A) = 10^(gainDb / 80); gainDb stays
+                // within +-48 dB, well inside exp2Unchecked's range
+                const auto sqrtA = (SampleType) FastMath::exp2Unchecked ((float) (gainDb * (SampleType) 0.0415241));
+                const auto A = sqrtA * sqrtA;
+                auto g = c.g, k = c.k;
+                SampleType m0 = 1, m1 = 0, m2 = 0;
+
+                if constexpr (Type == FilterType::peak)
+                {
+                    k /= A;
+                    m1 = k * (A * A - 1);
+                }
+                else if constexpr (Type == FilterType::lowShelf)
+                {
+                    g /= sqrtA;
+                    m1 = k * (A - 1);
+                    m2 = A * A - 1;
+                }
+                else
+                {
+                    g *= sqrtA;
+                    m0 = A * A;
+                    m1 = k * (1 - A) * A;
+                    m2 = 1 - A * A;
+                }
+
+                const auto a1 = (SampleType) 1 / ((SampleType) 1 + g * (g + k));
+                const auto a2 = g * a1;
+                const auto a3 = g * a2;
+
+                // Filter
+                const auto x = frame[l];
+                const auto v3 = x - ic2[l];
+                const auto v1 = a1 * ic1[l] + a2 * v3;
+                const auto v2 = ic2[l] + a2 * ic1[l] + a3 * v3;
+                ic1[l] = 2 * v1 - ic1[l];
+                ic2[l] = 2 * v2 - ic2[l];
+                frame[l] = m0 * x + m1 * v1 + m2 * v2;
+            }
+        }
+
+        s = local;
+    }
+};
+
+} // namespace iir
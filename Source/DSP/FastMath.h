@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace iir
+{
+
+//==============================================================================
+/** Cheap approximations for per-sample coefficient updates.
+
+    They are accurate to well below 0.1 % over the ranges the filters use,
+    which is far below what a modulated cutoff can resolve audibly.
+
+    The per-sample functions are force-inlined: the lane-group kernels are
+    also compiled for wider instruction sets, and an out-of-line copy built
+    there could be the one the linker keeps for every caller.
+*/
+namespace FastMath
+{
+    /** tan (x) for x in [0, pi/2), as a [5/4] Pade approximant.
+        Relative error is < 1e-6 below x = 1.2 and < 3e-4 at 0.49 * pi.
+    */
+    template <typename SampleType>
+    JUCE_FORCEINLINE SampleType tan (SampleType x) noexcept
+    {
+        const auto x2 = x * x;
+        const auto numerator   = x * ((SampleType) 945 + x2 * ((SampleType) -105 + x2));
+        const auto denominator = (SampleType) 945 + x2 * ((SampleType) -420 + x2 * (SampleType) 15);
+        return numerator / denominator;
+    }
+
+    /** 2^x for x in [-126, 126], from the exponent bits and a quartic for the
+        fractional part. The polynomial is pinned to 2 at f = 1, so the result
+        is continuous.
+
+        There are no comparisons, which matters in loops over lanes: with
+        strict IEEE flags a floating-point compare keeps the compiler from
+        vectorising the loop.
+    */
+    JUCE_FORCEINLINE float exp2Unchecked (float x) noexcept
+    {
+        // floor() by truncating a positive value
+        const auto whole = (float) ((int32_t) (x + 127.0f) - 127);
+        const auto f = x - whole;
+        const auto p = 1.0f + f * (0.6931472f + f * (0.2402265f + f * (0.0555041f + f * 0.0111222f)));
+
+        const auto bits = (uint32_t) ((int32_t) whole + 127) << 23;
+        float scale;
+        std::memcpy (&scale, &bits, sizeof (scale));
+        return p * scale;
+    }
+
+    /** 2^x, clamped to the range exp2Unchecked() can represent. */
+    JUCE_FORCEINLINE float exp2 (float x) noexcept
+    {
+        return exp2Unchecked (juce::jlimit (-126.0f, 126.0f, x));
+    }
+
+    /** log2 (x) for x > 0, from the exponent bits and a cubic for the mantissa.
+        The cubic is exact at both ends of the octave, so the result is
+        continuous; the error stays below 0.005.
+    */
+    JUCE_FORCEINLINE float log2 (float x) noexcept
+    {
+        uint32_t bits;
+        std::memcpy (&bits, &x, sizeof (bits));
+
+        const auto exponent = (float) ((int32_t) ((bits >> 23) & 0xff) - 127);
+        bits = (bits & 0x007fffffu) | 0x3f800000u;
+
+        float m;
+        std::memcpy (&m, &bits, sizeof (m));
+
+        const auto f = m - 1.0f;
+        return exponent + f * (1.4659912f + f * (-0.7062533f + f * 0.2402621f));
+    }
+}
+
+} // namespace iir
@@ -0,0 +1,355 @@
+#include "FilterEngine.h"
+
+namespace iir
+{
+
+//==============================================================================
+void FilterEngine::prepare (double newSampleRate, int maxBlockSize, int numChannels)
+{
+    jassert (newSampleRate > 0.0 && maxBlockSize > 0);
+
+    juce::ignoreUnused (maxBlockSize);
+
+    sampleRate = newSampleRate;
+    numPreparedChannels = juce::jmax (0, numChannels);
+
+    // A forced instruction set the CPU lacks would crash, so it falls back to choosing
+    auto isa = InstructionSets::choose (numPreparedChannels);
+    auto forced = forcedInstructionSet.value_or (isa);
+    const auto forceRequested = forcedInstructionSet.has_value() || InstructionSets::getForcedByEnvironment (forced);
+    instructionSetForced = forceRequested && InstructionSets::isSupported (forced);
+
+    if (instructionSetForced)
+        isa = forced;
+
+    if (laneGroups == nullptr || laneGroups->getInstructionSet() != isa)
+        laneGroups.reset (LaneGroupProcessor::create (isa));
+
+    // One core is the audio thread's, and a worker needs a group to take
+    const auto laneWidth = InstructionSets::getLaneWidth (isa);
+    const auto numGroups = (numPreparedChannels + laneWidth - 1) / laneWidth;
+    const auto numWorkers = numPreparedChannels < minChannelsForWorkers ? 0
+                          : juce::jmax (0, juce::jmin (maxNumWorkers, numGroups - 1,
+                                                       juce::SystemStats::getNumCpus() - 1));
+
+    if (numWorkers != getNumWorkers())
+        workerPool.reset (numWorkers > 0 ? new WorkerPool (numWorkers) : nullptr);
+
+    laneGroups->prepare (numPreparedChannels, numWorkers + 1);
+
+    const auto forcedSubBlockSize = juce::SystemStats::getEnvironmentVariable ("IIRFILTERS_SUB_BLOCK_SIZE", {}).getIntValue();
+
+    if (forcedSubBlockSize > 0)
+        setSubBlockSize (forcedSubBlockSize);
+
+    for (int band = 0; band < maxBands; ++band)
+        updateBand (band);
+
+    humTracker.prepare (sampleRate, settings.hum.getNominalFrequency());
+    updateHum (true);
+}
+
+void FilterEngine::release() noexcept
+{
+    if (laneGroups != nullptr)
+        laneGroups->release();
+
+    workerPool.reset();
+}
+
+InstructionSet FilterEngine::getInstructionSet() const noexcept
+{
+    return laneGroups != nullptr ? laneGroups->getInstructionSet() : InstructionSet::sse2;
+}
+
+int FilterEngine::getLaneWidth() const noexcept
+{
+    return InstructionSets::getLaneWidth (getInstructionSet());
+}
+
+int FilterEngine::getNumWorkers() const noexcept
+{
+    return workerPool != nullptr ? workerPool->getNumWorkers() : 0;
+}
+
+juce::String FilterEngine::describeKernels() const
+{
+    const auto numGroups = (numPreparedChannels + getLaneWidth() - 1) / getLaneWidth();
+
+    return juce::String (InstructionSets::getName (getInstructionSet())) + " kernels, "
+         + juce::String (getLaneWidth()) + " lanes, "
+         + juce::String (numGroups) + (numGroups == 1 ? " lane group" : " lane groups")
+         + " for " + juce::String (numPreparedChannels) + " channels"
+         + (getNumWorkers() == 1 ? ", 1 worker thread"
+                                 : getNumWorkers() > 1 ? ", " + juce::String (getNumWorkers()) + " worker threads" : juce::String())
+         + (instructionSetForced ? " (forced)" : "")
+         + ", sub-blocks of " + juce::String (subBlockSize) + " frames";
+}
+
+void FilterEngine::setSubBlockSize (int numFrames) noexcept
+{
+    subBlockSize = juce::jlimit (minSubBlockSize, maxSubBlockSize, numFrames);
+}
+
+void FilterEngine::reset() noexcept
+{
+    for (int section = 0; section < LaneGroupProcessor::maxSections; ++section)
+        resetSection (section);
+}
+
+void FilterEngine::resetSection (int section) noexcept
+{
+    if (laneGroups != nullptr)
+        laneGroups->resetSection (section);
+}
+
+void FilterEngine::setSettings (const FilterSettings& newSettings) noexcept
+{
+    if (newSettings.midSide != settings.midSide)
+    {
+        settings.midSide = newSettings.midSide;
+
+        if (laneGroups != nullptr && numPreparedChannels >= 2)
+            laneGroups->convertToMidSide (settings.midSide);
+    }
+
+    for (int band = 0; band < maxBands; ++band)
+    {
+        const auto& newBand = newSettings.bands[(size_t) band];
+        const auto& newDynamics = newSettings.dynamics[(size_t) band];
+        auto& oldBand = settings.bands[(size_t) band];
+        auto& oldDynamics = settings.dynamics[(size_t) band];
+
+        if (newBand != oldBand || newDynamics != oldDynamics)
+        {
+            const auto topologyChanged = newBand.topology != oldBand.topology;
+            const auto wasDynamic = dynamic[(size_t) band];
+
+            oldBand = newBand;
+            oldDynamics = newDynamics;
+            updateBand (band);
+
+            // The state variables mean different things in each topology
+            if (topologyChanged || dynamic[(size_t) band] != wasDynamic)
+                resetSection (band);
+        }
+    }
+
+    if (newSettings.hum != settings.hum)
+    {
+        const auto restart = newSettings.hum.enabled
+                          && (! settings.hum.enabled || newSettings.hum.mains != settings.hum.mains);
+        const auto retrack = restart || (newSettings.hum.track && ! settings.hum.track);
+
+        settings.hum = newSettings.hum;
+
+        if (retrack)
+            humTracker.setNominalFrequency (settings.hum.getNominalFrequency());
+
+        updateHum (restart);
+    }
+}
+
+void FilterEngine::updateBand (int band) noexcept
+{
+    const auto& b = settings.bands[(size_t) band];
+
+    coefficients[(size_t) band] = b.enabled ? SectionCoefficients<float>::design (b, sampleRate)
+                                            : SectionCoefficients<float>::identity();
+    bandTailSamples[(size_t) band] = b.enabled ? BiquadCoefficients<double>::design (b, sampleRate).getDecaySamples() : 0.0;
+
+    const auto& d = settings.dynamics[(size_t) band];
+    dynamic[(size_t) band] = b.enabled && d.enabled && DynamicBandCoefficients<float>::supports (b.type);
+    keyed[(size_t) band] = dynamic[(size_t) band] && d.sidechain;
+
+    if (dynamic[(size_t) band])
+        dynamicCoefficients[(size_t) band] = DynamicBandCoefficients<float>::design (b, d, sampleRate);
+}
+
+void FilterEngine::updateHum (bool restart) noexcept
+{
+    const auto& h = settings.hum;
+    const auto fundamental = h.track ? humTracker.getFrequency() : h.getNominalFrequency();
+    auto numSections = 0;
+    auto tailSamples = 0.0;
+
+    if (h.enabled)
+    {
+        // Each notch gets the same width in Hz, so its Q rises with the harmonic
+        BandSettings notch;
+        notch.enabled = true;
+        notch.type = FilterType::notch;
+        notch.topology = Topology::errorFeedback;
+
+        for (int harmonic = 1; harmonic <= juce::jmin (h.numHarmonics, maxHumHarmonics); ++harmonic)
+        {
+            const auto frequency = fundamental * harmonic;
+
+            if (frequency >= 0.45 * sampleRate)
+                break;
+
+            notch.frequency = (float) frequency;
+            notch.q = (float) (frequency / juce::jmax (0.1, (double) h.widthHz));
+
+            humStage.coefficients[(size_t) numSections++] = SectionCoefficients<float>::design (notch, sampleRate);
+            tailSamples += BiquadCoefficients<double>::design (notch, sampleRate).getDecaySamples();
+        }
+    }
+
+    // Notches that were already running keep their state while they move
+    for (int i = restart ? 0 : humStage.numSections; i < numSections; ++i)
+        resetSection (LaneGroupProcessor::firstHumSection + i);
+
+    humStage.fundamental = fundamental;
+    humStage.numSections = numSections;
+    humStage.tailSamples = tailSamples;
+}
+
+void FilterEngine::setCascade (int slot, const CascadeDesign* design) noexcept
+{
+    jassert (juce::isPositiveAndBelow (slot, (int) numCutSlots));
+    auto& stage = cutStages[(size_t) slot];
+
+    if (design == nullptr)
+    {
+        stage.active = false;
+        return;
+    }
+
+    applyCascade (slot, design->spec, design->sections.data(), (int) design->sections.size());
+}
+
+void FilterEngine::setCascade (int slot, const CascadeSpec& spec, const DesignTables::PresetCascade& preset) noexcept
+{
+    jassert (juce::isPositiveAndBelow (slot, (int) numCutSlots));
+    applyCascade (slot, spec, preset.sections.data(), preset.numSections);
+}
+
+void FilterEngine::applyCascade (int slot, const CascadeSpec& spec,
+                                 const BiquadCoefficients<double>* sections, int numSectionsToUse) noexcept
+{
+    auto& stage = cutStages[(size_t) slot];
+
+    if (stage.active && stage.spec == spec)
+        return;
+
+    const auto numSections = juce::jmin (numSectionsToUse, maxCascadeSections);
+
+    // Keep the state while only the coefficients move, but start from silence
+    // when the cascade is switched on or its structure changes
+    if (! stage.active || numSections != stage.numSections)
+        for (int i = 0; i < maxCascadeSections; ++i)
+            resetSection (LaneGroupProcessor::firstCutSection (slot) + i);
+
+    stage.tailSamples = 0.0;
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        stage.coefficients[(size_t) i] = SectionCoefficients<float>::fromBiquad (sections[i], Topology::errorFeedback);
+        stage.tailSamples += sections[i].getDecaySamples();
+    }
+
+    stage.active = true;
+    stage.spec = spec;
+    stage.numSections = numSections;
+}
+
+double FilterEngine::getTailSamples() const noexcept
+{
+    auto result = std::accumulate (bandTailSamples.begin(), bandTailSamples.end(), humStage.tailSamples);
+
+    for (const auto& stage : cutStages)
+        if (stage.active)
+            result += stage.tailSamples;
+
+    return result;
+}
+
+//==============================================================================
+void FilterEngine::process (float* const* channels, int numChannels, int numSamples,
+                            const float* const* sidechain, int numSidechainChannels) noexcept
+{
+    // Not prepared, or released
+    if (laneGroups == nullptr || laneGroups->getNumChannels() == 0)
+        return;
+
+    jassert (numChannels <= laneGroups->getNumChannels());
+    numChannels = juce::jmin (numChannels, laneGroups->getNumChannels());
+
+    const auto anyEnabled = std::any_of (settings.bands.begin(), settings.bands.end(),
+                                         [] (const BandSettings& b) { return b.enabled; })
+                         || std::any_of (cutStages.begin(), cutStages.end(),
+                                         [] (const CutStage& c) { return c.active; })
+                         || humStage.numSections > 0;
+
+    if (! anyEnabled || numChannels <= 0)
+        return;
+
+    if (humStage.numSections > 0 && settings.hum.track)
+    {
+        humTracker.process (channels[0], numChannels > 1 ? channels[1] : nullptr, numSamples);
+
+        if (std::abs (humTracker.getFrequency() - humStage.fundamental) > humRetuneHz)
+            updateHum (false);
+    }
+
+    const auto anyKeyed = sidechain != nullptr && numSidechainChannels > 0
+                       && std::find (keyed.begin(), keyed.end(), true) != keyed.end();
+
+    LaneGroupSetup setup;
+    setup.bands = settings.bands.data();
+    setup.dynamic = dynamic.data();
+    setup.keyed = keyed.data();
+    setup.coefficients = coefficients.data();
+    setup.dynamicCoefficients = dynamicCoefficients.data();
+    setup.midSide = settings.midSide && numChannels >= 2;
+    setup.subBlockSize = subBlockSize;
+
+    for (int slot = 0; slot < numCutSlots; ++slot)
+    {
+        const auto& stage = cutStages[(size_t) slot];
+        setup.cuts[(size_t) slot] = stage.coefficients.data();
+        setup.numCutSections[(size_t) slot] = stage.active ? stage.numSections : 0;
+    }
+
+    setup.hum = humStage.coefficients.data();
+    setup.numHumSections = humStage.numSections;
+
+    struct GroupJob final : WorkerPool::Job
+    {
+        GroupJob (LaneGroupProcessor& p, const LaneGroupSetup& s, float* const* c, int nc, int ns,
+                  const float* const* sc, int nsc) noexcept
+            : processor (p), setup (s), channels (c), numChannels (nc), numSamples (ns),
+              sidechain (sc), numSidechainChannels (nsc) {}
+
+        void run (int group, int participant) noexcept override
+        {
+            processor.process (setup, channels, numChannels, numSamples,
+                               sidechain, numSidechainChannels, group, participant);
+        }
+
+        LaneGroupProcessor& processor;
+        const LaneGroupSetup& setup;
+        float* const* channels;
+        const int numChannels, numSamples;
+        const float* const* sidechain;
+        const int numSidechainChannels;
+    };
+
+    GroupJob job (*laneGroups, setup, channels, numChannels, numSamples,
+                  anyKeyed ? sidechain : nullptr, numSidechainChannels);
+
+    const auto numGroups = (numChannels + laneGroups->getLaneWidth() - 1) / laneGroups->getLaneWidth();
+
+    if (workerPool != nullptr && numGroups > 1)
+    {
+        workerPool->run (job, numGroups);
+    }
+    else
+    {
+        for (int group = 0; group < numGroups; ++group)
+            job.run (group, 0);
+    }
+}
+
+} // namespace iir
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "CascadeDesigner.h"
+#include "DesignTables.h"
+#include "DynamicBand.h"
+#include "HumTracker.h"
+#include "LaneGroupProcessor.h"
+#include "WorkerPool.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** Runs the EQ band cascade over a block of audio.
+
+    Channels are processed in lane groups as wide as one vector register of
+    the chosen instruction set: each group is interleaved into a scratch
+    buffer, the low cut, every enabled band and the high cut run over it with
+    the kernel for their topology, and the result is written back.
+    Band coefficients are only redesigned for bands whose settings changed; the
+    cut cascades are designed elsewhere and passed in with setCascade().
+
+    Peak and shelf bands with dynamics enabled run the DynamicBandKernel
+    instead, keyed either from their own input or from the sidechain, which is
+    interleaved alongside the audio.
+
+    In mid/side mode the first two lanes are encoded to mid and side right
+    after interleaving and decoded right before writing back, so the whole
+    chain runs on M and S side by side in the same registers without any
+    extra pass over the host buffers. A band placed on mid or side runs over
+    both lanes like any other and then has the lane it shouldn't touch put
+    back.
+
+    Hum removal adds a notch at the mains frequency and at each harmonic
+    right after the low cut. With tracking on, a HumTracker follows the first
+    two input channels and the notches are redesigned whenever the measured
+    frequency has moved by more than humRetuneHz, so they stay narrow and
+    still land on the hum as the supply drifts.
+
+    The kernels are built once per InstructionSet, and prepare() picks the
+    one that suits this CPU and channel count; see InstructionSets::choose().
+
+    Lane groups are independent of each other, so with enough channels they
+    are shared out between the audio thread and a small WorkerPool, each
+    thread with its own scratch buffer. process() returns only once every
+    group is done.
+*/
+class FilterEngine
+{
+public:
+    FilterEngine() = default;
+
+    /** Host blocks are processed in sub-blocks of this many frames: every
+        section runs over one sub-block before the next one is interleaved, so
+        the frames, states and coefficients in use stay in L1 however large the
+        host's blocks are. Below 32 the per-pass overhead starts to show.
+    */
+    static constexpr int minSubBlockSize = 32;
+    static constexpr int maxSubBlockSize = LaneGroupProcessor::maxFrames;
+    static constexpr int defaultSubBlockSize = 128;
+
+    /** Below this many channels every group runs on the audio thread: waking
+        a worker costs more than it saves.
+    */
+    static constexpr int minChannelsForWorkers = 32;
+    static constexpr int defaultMaxNumWorkers = 3;
+
+    /** How far the tracked mains frequency may move before the hum notches follow. */
+    static constexpr double humRetuneHz = 0.01;
+
+    /** Chooses the kernels and allocates state and scratch space for the
+        given layout. Not real-time safe.
+    */
+    void prepare (double newSampleRate, int maxBlockSize, int numChannels);
+
+    /** Frees the state and scratch space and stops the workers. Until the
+        next prepare(), process() leaves the audio alone; the settings and
+        coefficients are kept.
+    */
+    void release() noexcept;
+
+    /** Makes the following prepare() calls use the kernels for the given
+        instruction set instead of choosing, for testing; an empty value goes
+        back to choosing. The IIRFILTERS_FORCE_ISA environment variable does
+        the same for every instance in the process. An instruction set this CPU
+        doesn't support is never used, whatever is forced.
+    */
+    void setForcedInstructionSet (std::optional<InstructionSet> isa) noexcept  { forcedInstructionSet = isa; }
+
+    /** Limits the worker threads the following prepare() calls start, on top
+        of the audio thread; 0 keeps all the work on the audio thread. Fewer
+        are started if there are fewer spare cores or lane groups.
+    */
+    void setMaxNumWorkers (int numWorkers) noexcept  { maxNumWorkers = juce::jmax (0, numWorkers); }
+
+    /** The instruction set and lane width the last prepare() settled on. */
+    InstructionSet getInstructionSet() const noexcept;
+    int getLaneWidth() const noexcept;
+
+    /** The worker threads the last prepare() started. */
+    int getNumWorkers() const noexcept;
+
+    /** A line for the log saying which kernels run and why, e.g.
+        "AVX2 kernels, 8 lanes, 1 lane group for 6 channels, sub-blocks of 128 frames".
+    */
+    juce::String describeKernels() const;
+
+    /** Sets the sub-block length, clamped to [minSubBlockSize, maxSubBlockSize].
+        Real-time safe, as the scratch space always fits the largest size.
+        prepare() sets it from the IIRFILTERS_SUB_BLOCK_SIZE environment
+        variable when that holds a number, to tune a machine without a rebuild;
+        IIRSubBlockBenchmark measures the candidates.
+    */
+    void setSubBlockSize (int numFrames) noexcept;
+
+    int getSubBlockSize() const noexcept  { return subBlockSize; }
+
+    /** Clears all filter state without touching the coefficients. */
+    void reset() noexcept;
+
+    /** Takes over new settings, redesigning only the bands that changed. */
+    void setSettings (const FilterSettings& newSettings) noexcept;
+
+    const FilterSettings& getSettings() const noexcept  { return settings; }
+
+    /** The fundamental the hum notches are tuned to, or 0 while hum removal is off. */
+    double getHumFrequency() const noexcept  { return humStage.numSections > 0 ? humStage.fundamental : 0.0; }
+
+    /** How long the output keeps ringing once the input stops, in samples: the
+        sum of the decay times of every running section, which bounds that of
+        sections in series. Follows the settings and the cascades.
+    */
+    double getTailSamples() const noexcept;
+
+    /** Takes over a designed cascade for one of the cut slots, or bypasses the
+        slot if design is nullptr. Cheap when the design hasn't changed, so it
+        can be called every block. The design is copied, so the pointer needn't
+        outlive the call.
+    */
+    void setCascade (int slot, const CascadeDesign* design) noexcept;
+
+    /** Takes over a ready-made design from DesignTables for the given spec. */
+    void setCascade (int slot, const CascadeSpec& spec, const DesignTables::PresetCascade& preset) noexcept;
+
+    /** Filters the given channels in place, one sub-block at a time.
+
+        Dynamic bands set to follow the sidechain use the given sidechain
+        channels, mapping any channel beyond the last one onto the last. With
+        no sidechain they follow their own input.
+    */
+    void process (float* const* channels, int numChannels, int numSamples,
+                  const float* const* sidechain = nullptr, int numSidechainChannels = 0) noexcept;
+
+private:
+    //==============================================================================
+    struct CutStage
+    {
+        bool active = false;
+        CascadeSpec spec;
+        int numSections = 0;
+        double tailSamples = 0.0;
+        std::array<SectionCoefficients<float>, maxCascadeSections> coefficients;
+    };
+
+    struct HumStage
+    {
+        double fundamental = 0.0;
+        int numSections = 0;
+        double tailSamples = 0.0;
+        std::array<SectionCoefficients<float>, maxHumHarmonics> coefficients;
+    };
+
+    void updateBand (int band) noexcept;
+    void updateHum (bool restart) noexcept;
+    void applyCascade (int slot, const CascadeSpec& spec, const BiquadCoefficients<double>* sections, int numSectionsToUse) noexcept;
+    void resetSection (int section) noexcept;
+
+    double sampleRate = 44100.0;
+    FilterSettings settings;
+    // The state and scratch live in the lane groups' arena; the coefficients
+    // stay here, as they are designed before the first prepare() too, but each
+    // array starts on a cache line of its own
+    alignas (64) std::array<SectionCoefficients<float>, maxBands> coefficients;
+    alignas (64) std::array<CutStage, numCutSlots> cutStages;
+    alignas (64) std::array<DynamicBandCoefficients<float>, maxBands> dynamicCoefficients;
+    alignas (64) HumStage humStage;
+    HumTracker humTracker;
+    std::array<bool, maxBands> dynamic {}, keyed {};
+    std::array<double, maxBands> bandTailSamples {};
+    std::unique_ptr<LaneGroupProcessor> laneGroups;
+    std::unique_ptr<WorkerPool> workerPool;
+    std::optional<InstructionSet> forcedInstructionSet;
+    bool instructionSetForced = false;
+    int subBlockSize = defaultSubBlockSize, numPreparedChannels = 0;
+    int maxNumWorkers = defaultMaxNumWorkers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FilterEngine)
+};
+
+} // namespace iir
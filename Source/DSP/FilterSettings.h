@@ -0,0 +1,294 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace iir
+{
+
+//==============================================================================
+enum class FilterType
+{
+    lowPass,
+    highPass,
+    bandPass,
+    notch,
+    peak,
+    lowShelf,
+    highShelf
+};
+
+constexpr int numFilterTypes = 7;
+constexpr int maxBands = 8;
+
+//==============================================================================
+/** The structure used to realise a band's second-order section.
+
+    They all implement the same transfer function but differ in cost, in
+    coefficient sensitivity at low cutoffs and in how they cope with
+    coefficient changes.
+*/
+enum class Topology
+{
+    directForm1,
+    transposedDirectForm2,
+    stateVariable,
+    normalisedLattice,
+    coupledForm,
+    errorFeedback
+};
+
+constexpr int numTopologies = 6;
+
+//==============================================================================
+/** Which channel a band acts on while the engine runs in mid/side mode. In
+    left/right mode every band acts on both channels.
+*/
+enum class Placement
+{
+    stereo,
+    mid,
+    side
+};
+
+constexpr int numPlacements = 3;
+
+//==============================================================================
+/** The user-facing description of a single EQ band. */
+struct BandSettings
+{
+    bool enabled = false;
+    FilterType type = FilterType::peak;
+    float frequency = 1000.0f;
+    float q = 0.70710678f;
+    float gainDb = 0.0f;
+    Topology topology = Topology::transposedDirectForm2;
+    Placement placement = Placement::stereo;
+
+    bool operator== (const BandSettings& other) const noexcept
+    {
+        return enabled == other.enabled
+            && type == other.type
+            && topology == other.topology
+            && placement == other.placement
+            && frequency == other.frequency
+            && q == other.q
+            && gainDb == other.gainDb;
+    }
+
+    bool operator!= (const BandSettings& other) const noexcept  { return ! operator== (other); }
+};
+
+//==============================================================================
+/** The analog prototype behind a steep cut filter. */
+enum class PrototypeFamily
+{
+    butterworth,
+    chebyshev,
+    elliptic
+};
+
+constexpr int numPrototypeFamilies = 3;
+constexpr int maxCutOrder = 24;
+
+/** A steep low or high cut made of a cascade of second-order sections.
+
+    The frequency is the -3 dB point for Butterworth and the passband edge (the
+    end of the ripple band) for Chebyshev and elliptic designs.
+*/
+struct CutSettings
+{
+    bool enabled = false;
+    PrototypeFamily family = PrototypeFamily::butterworth;
+    int order = 4;
+    float frequency = 1000.0f;
+    float rippleDb = 0.5f;
+    float attenuationDb = 60.0f;
+
+    bool operator== (const CutSettings& other) const noexcept
+    {
+        return enabled == other.enabled
+            && family == other.family
+            && order == other.order
+            && frequency == other.frequency
+            && rippleDb == other.rippleDb
+            && attenuationDb == other.attenuationDb;
+    }
+
+    bool operator!= (const CutSettings& other) const noexcept  { return ! operator== (other); }
+};
+
+/** Index into FilterSettings::cuts. */
+enum CutSlot
+{
+    lowCut,
+    highCut,
+    numCutSlots
+};
+
+//==============================================================================
+/** An extra band whose cutoff and Q are modulated at audio rate by an LFO and
+    an envelope follower. Modulation depths are in octaves.
+*/
+struct ModulationSettings
+{
+    bool enabled = false;
+    FilterType type = FilterType::lowPass;
+    float frequency = 1000.0f;
+    float q = 0.70710678f;
+    float gainDb = 0.0f;
+
+    float lfoRateHz = 1.0f;
+    float lfoToCutoff = 0.0f;
+    float lfoToQ = 0.0f;
+
+    float envelopeAttackMs = 5.0f;
+    float envelopeReleaseMs = 100.0f;
+    float envelopeToCutoff = 0.0f;
+    float envelopeToQ = 0.0f;
+};
+
+//==============================================================================
+/** Level-dependent gain for a peak or shelf band.
+
+    A bandpass detector at the band's frequency and Q follows either the
+    band's own input or the sidechain bus. While it is above the threshold
+    the band's gain is pulled down by (level - threshold) * (1 - 1 / ratio),
+    by at most rangeDb.
+*/
+struct DynamicsSettings
+{
+    bool enabled = false;
+    bool sidechain = false;
+    float thresholdDb = -24.0f;
+    float ratio = 4.0f;
+    float attackMs = 5.0f;
+    float releaseMs = 80.0f;
+    float rangeDb = 12.0f;
+
+    bool operator== (const DynamicsSettings& other) const noexcept
+    {
+        return enabled == other.enabled
+            && sidechain == other.sidechain
+            && thresholdDb == other.thresholdDb
+            && ratio == other.ratio
+            && attackMs == other.attackMs
+            && releaseMs == other.releaseMs
+            && rangeDb == other.rangeDb;
+    }
+
+    bool operator!= (const DynamicsSettings& other) const noexcept  { return ! operator== (other); }
+};
+
+//==============================================================================
+/** The nominal frequency of the mains supply whose hum is removed. */
+enum class MainsFrequency
+{
+    hz50,
+    hz60
+};
+
+constexpr int numMainsFrequencies = 2;
+constexpr int maxHumHarmonics = 8;
+
+/** Narrow notches at the mains frequency and its harmonics.
+
+    Every notch has the same width in Hz, so the upper harmonics are cut as
+    precisely as the fundamental. With tracking on, the notches follow the
+    mains frequency measured from the input instead of sitting at the nominal
+    one.
+*/
+struct HumSettings
+{
+    bool enabled = false;
+    MainsFrequency mains = MainsFrequency::hz50;
+    int numHarmonics = 4;
+    float widthHz = 2.0f;
+    bool track = true;
+
+    double getNominalFrequency() const noexcept  { return mains == MainsFrequency::hz60 ? 60.0 : 50.0; }
+
+    bool operator== (const HumSettings& other) const noexcept
+    {
+        return enabled == other.enabled
+            && mains == other.mains
+            && numHarmonics == other.numHarmonics
+            && widthHz == other.widthHz
+            && track == other.track;
+    }
+
+    bool operator!= (const HumSettings& other) const noexcept  { return ! operator== (other); }
+};
+
+//==============================================================================
+/** The resonator bank that follows the filters. Its modes come from a table
+    loaded separately; see ResonatorBank.
+*/
+struct ResonatorSettings
+{
+    bool enabled = false;
+    float mix = 0.5f;
+};
+
+//==============================================================================
+/** The Linkwitz-Riley order of the crossover's splits: two or four cascaded
+    Butterworth sections per side, 24 or 48 dB per octave.
+*/
+enum class CrossoverSlope
+{
+    lr4,
+    lr8
+};
+
+constexpr int numCrossoverSlopes = 2;
+constexpr int maxCrossoverBands = 8;
+
+/** Splits the output into numBands bands, each sent to an output bus of its
+    own, at the first numBands - 1 frequencies. The bands are in phase with
+    each other and sum back to the output with a flat magnitude response.
+*/
+struct CrossoverSettings
+{
+    bool enabled = false;
+    int numBands = 3;
+    CrossoverSlope slope = CrossoverSlope::lr4;
+    std::array<float, maxCrossoverBands - 1> frequencies { { 100.0f, 400.0f, 1600.0f, 3200.0f, 6400.0f, 10000.0f, 15000.0f } };
+
+    bool operator== (const CrossoverSettings& other) const noexcept
+    {
+        return enabled == other.enabled
+            && numBands == other.numBands
+            && slope == other.slope
+            && frequencies == other.frequencies;
+    }
+
+    bool operator!= (const CrossoverSettings& other) const noexcept  { return ! operator== (other); }
+};
+
+//==============================================================================
+/** Everything the audio thread needs to know to run the filter engine.
+
+    This is plain data: the audio thread owns its copy and only ever changes it
+    from inside processBlock.
+*/
+struct FilterSettings
+{
+    std::array<BandSettings, maxBands> bands;
+    ModulationSettings modulation;
+    std::array<CutSettings, numCutSlots> cuts { { { false, PrototypeFamily::butterworth, 4, 30.0f },
+                                                  { false, PrototypeFamily::butterworth, 4, 18000.0f } } };
+    std::array<DynamicsSettings, maxBands> dynamics;
+    HumSettings hum;
+    ResonatorSettings resonator;
+    CrossoverSettings crossover;
+
+    /** Runs the first two channels as mid and side instead of left and right. */
+    bool midSide = false;
+
+    /** Keeps the filters running while the plug-in is bypassed, so they come
+        back with their state instead of from silence. Read by the processor,
+        not the engine.
+    */
+    bool warmBypass = false;
+};
+
+} // namespace iir
@@ -0,0 +1,100 @@
+#include "HumTracker.h"
+
+namespace iir
+{
+
+//==============================================================================
+void HumTracker::prepare (double newSampleRate, double nominalHz) noexcept
+{
+    jassert (newSampleRate > 0.0);
+
+    sampleRate = newSampleRate;
+    setNominalFrequency (nominalHz);
+}
+
+void HumTracker::setNominalFrequency (double hz) noexcept
+{
+    jassert (hz > 0.0);
+
+    nominal = hz;
+    decimation = juce::jmax (1, juce::roundToInt (sampleRate / (samplesPerCycle * nominal)));
+    decimatedRate = sampleRate / (double) decimation;
+
+    // Wide enough to pass the whole tracking range without much loss, narrow
+    // enough to keep the harmonics and most of the noise off the crossings
+    BandSettings band;
+    band.enabled = true;
+    band.type = FilterType::bandPass;
+    band.frequency = (float) nominal;
+    band.q = 3.0f;
+    bandPass = BiquadCoefficients<double>::design (band, decimatedRate);
+
+    // About ten cycles
+    levelCoefficient = 1.0 - std::exp (-1.0 / (10.0 * samplesPerCycle));
+
+    reset();
+}
+
+void HumTracker::reset() noexcept
+{
+    frequency = nominal;
+    numAccumulated = 0;
+    accumulator = 0.0;
+    x1 = x2 = y1 = y2 = 0.0;
+    meanSquare = 0.0;
+    samplesSinceCrossing = 0.0;
+    hasCrossing = false;
+}
+
+//==============================================================================
+void HumTracker::process (const float* left, const float* right, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // A plain average is a poor low pass, but whatever it lets alias down
+        // to the mains frequency is the band pass's problem, not the timing's
+        accumulator += right != nullptr ? 0.5 * ((double) left[i] + (double) right[i]) : (double) left[i];
+
+        if (++numAccumulated == decimation)
+        {
+            processDecimated (accumulator / (double) decimation);
+            accumulator = 0.0;
+            numAccumulated = 0;
+        }
+    }
+}
+
+void HumTracker::processDecimated (double x) noexcept
+{
+    const auto y = bandPass.b0 * x + bandPass.b1 * x1 + bandPass.b2 * x2
+                 - bandPass.a1 * y1 - bandPass.a2 * y2;
+
+    meanSquare += levelCoefficient * (y * y - meanSquare);
+
+    if (y1 < 0.0 && y >= 0.0)
+    {
+        // The crossing lies this fraction of a sample after the previous one
+        const auto fraction = y1 / (y1 - y);
+        const auto period = samplesSinceCrossing + fraction;
+
+        if (hasCrossing && meanSquare > minLevel * minLevel)
+        {
+            const auto measured = decimatedRate / period;
+
+            if (std::abs (measured - nominal) <= maxDeviation * nominal)
+                frequency += 0.2 * (measured - frequency);
+        }
+
+        samplesSinceCrossing = 1.0 - fraction;
+        hasCrossing = true;
+    }
+    else
+    {
+        samplesSinceCrossing += 1.0;
+    }
+
+    x2 = x1; x1 = x;
+    y2 = y1; y1 = y;
+}
+
+} // namespace iir
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "BiquadCoefficients.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** Measures the mains frequency from the hum in a recording.
+
+    The input is averaged down to about twenty samples per mains cycle, band
+    passed around the nominal frequency and timed from one rising zero
+    crossing to the next, interpolated between samples. Each period that
+    lands within maxDeviation of the nominal frequency moves the estimate a
+    fifth of the way towards it, so it settles within a few cycles and
+    ignores the odd crossing that noise adds or removes. Below minLevel there is no hum to follow and the
+    estimate stays where it was.
+
+    It costs an add per input sample and a biquad per decimated one, so it
+    can run on every block.
+*/
+class HumTracker
+{
+public:
+    HumTracker() = default;
+
+    static constexpr double maxDeviation = 0.04;        // of the nominal frequency
+    static constexpr double minLevel = 1.0e-4;          // RMS of the band-passed hum
+    static constexpr double samplesPerCycle = 20.0;     // after decimation
+
+    void prepare (double newSampleRate, double nominalHz) noexcept;
+
+    /** Starts tracking again from the given nominal frequency, e.g. 50 or 60 Hz. */
+    void setNominalFrequency (double hz) noexcept;
+
+    /** Forgets the measurement and goes back to the nominal frequency. */
+    void reset() noexcept;
+
+    /** Follows the hum in one channel, or the sum of two if right isn't nullptr. */
+    void process (const float* left, const float* right, int numSamples) noexcept;
+
+    /** The measured mains frequency in Hz, or the nominal one until there is a measurement. */
+    double getFrequency() const noexcept  { return frequency; }
+
+private:
+    //==============================================================================
+    void processDecimated (double x) noexcept;
+
+    double sampleRate = 44100.0, decimatedRate = 1000.0;
+    double nominal = 50.0, frequency = 50.0;
+    int decimation = 1, numAccumulated = 0;
+    double accumulator = 0.0;
+
+    BiquadCoefficients<double> bandPass;
+    double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+    double meanSquare = 0.0, levelCoefficient = 0.0;
+    double samplesSinceCrossing = 0.0;
+    bool hasCrossing = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HumTracker)
+};
+
+} // namespace iir
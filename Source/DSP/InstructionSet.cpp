@@ -0,0 +1,79 @@
+#include "InstructionSet.h"
+
+namespace iir
+{
+namespace InstructionSets
+{
+
+//==============================================================================
+const char* getName (InstructionSet isa) noexcept
+{
+    switch (isa)
+    {
+        case InstructionSet::sse2:    return "SSE2";
+        case InstructionSet::avx2:    return "AVX2";
+        case InstructionSet::avx512:  return "AVX-512";
+    }
+
+    jassertfalse;
+    return "";
+}
+
+bool isSupported (InstructionSet isa) noexcept
+{
+    // Must match the flags the kernel translation units are compiled with
+    switch (isa)
+    {
+        case InstructionSet::sse2:    return true;
+        case InstructionSet::avx2:    return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+        case InstructionSet::avx512:  return isSupported (InstructionSet::avx2)
+                                          && juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX512VL();
+    }
+
+    jassertfalse;
+    return false;
+}
+
+bool fromName (const juce::String& name, InstructionSet& result) noexcept
+{
+    for (int i = 0; i < numInstructionSets; ++i)
+    {
+        const auto isa = (InstructionSet) i;
+
+        if (name.trim().removeCharacters ("-").equalsIgnoreCase (juce::String (getName (isa)).removeCharacters ("-")))
+        {
+            result = isa;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool getForcedByEnvironment (InstructionSet& result)
+{
+    return fromName (juce::SystemStats::getEnvironmentVariable ("IIRFILTERS_FORCE_ISA", {}), result);
+}
+
+InstructionSet choose (int numChannels) noexcept
+{
+    auto best = InstructionSet::sse2;
+
+    for (int i = 0; i < numInstructionSets; ++i)
+    {
+        const auto isa = (InstructionSet) i;
+
+        if (! isSupported (isa))
+            break;
+
+        best = isa;
+
+        if (getLaneWidth (isa) >= numChannels)
+            break;
+    }
+
+    return best;
+}
+
+} // namespace InstructionSets
+} // namespace iir
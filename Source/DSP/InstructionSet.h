@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace iir
+{
+
+//==============================================================================
+/** The instruction sets the lane-group kernels are built for.
+
+    sse2 is the baseline build, i.e. whatever the target guarantees: SSE2 on
+    x86-64 and NEON on arm64. The others live in translation units of their
+    own that are compiled for that instruction set, and are only ever run
+    once the CPU has reported it.
+*/
+enum class InstructionSet
+{
+    sse2,
+    avx2,
+    avx512
+};
+
+constexpr int numInstructionSets = 3;
+
+namespace InstructionSets
+{
+    /** Channels per lane group: one full vector register of floats. */
+    constexpr int getLaneWidth (InstructionSet isa) noexcept
+    {
+        return isa == InstructionSet::avx512 ? 16 : isa == InstructionSet::avx2 ? 8 : 4;
+    }
+
+    /** A display name such as "AVX2". */
+    const char* getName (InstructionSet isa) noexcept;
+
+    /** True if this CPU can run the kernels built for the instruction set. */
+    bool isSupported (InstructionSet isa) noexcept;
+
+    /** Parses "sse2", "avx2" or "avx512", ignoring case. Returns false and
+        leaves result alone for anything else.
+    */
+    bool fromName (const juce::String& name, InstructionSet& result) noexcept;
+
+    /** Reads the IIRFILTERS_FORCE_ISA environment variable, which forces an
+        instruction set for the whole process when testing.
+    */
+    bool getForcedByEnvironment (InstructionSet& result);
+
+    /** The supported instruction set that fits numChannels into the fewest
+        lane groups with the fewest idle lanes: the narrowest one whose lanes
+        hold every channel, or the widest supported if none does. A wider
+        register only buys throughput when there are channels to fill it.
+    */
+    InstructionSet choose (int numChannels) noexcept;
+}
+
+} // namespace iir
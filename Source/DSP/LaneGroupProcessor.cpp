@@ -0,0 +1,29 @@
+#include "LaneGroupProcessor.h"
+
+namespace iir
+{
+
+// Defined in LaneGroupsSse2.cpp, LaneGroupsAvx2.cpp and LaneGroupsAvx512.cpp
+LaneGroupProcessor* createSse2LaneGroups();
+LaneGroupProcessor* createAvx2LaneGroups();
+LaneGroupProcessor* createAvx512LaneGroups();
+
+//==============================================================================
+LaneGroupProcessor::~LaneGroupProcessor() = default;
+
+LaneGroupProcessor* LaneGroupProcessor::create (InstructionSet isa)
+{
+    jassert (InstructionSets::isSupported (isa));
+
+    switch (isa)
+    {
+        case InstructionSet::sse2:    return createSse2LaneGroups();
+        case InstructionSet::avx2:    return createAvx2LaneGroups();
+        case InstructionSet::avx512:  return createAvx512LaneGroups();
+    }
+
+    jassertfalse;
+    return createSse2LaneGroups();
+}
+
+} // namespace iir
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CascadeDesigner.h"
+#include "DynamicBand.h"
+#include "InstructionSet.h"
+#include "Topologies.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** Everything a lane-group pass reads from FilterEngine for one block. The
+    pointers refer to the engine's own arrays of maxBands entries.
+*/
+struct LaneGroupSetup
+{
+    const BandSettings* bands = nullptr;
+    const bool* dynamic = nullptr;                       // bands run by the DynamicBandKernel
+    const bool* keyed = nullptr;                         // dynamic bands following the sidechain
+    const SectionCoefficients<float>* coefficients = nullptr;
+    const DynamicBandCoefficients<float>* dynamicCoefficients = nullptr;
+    std::array<const SectionCoefficients<float>*, numCutSlots> cuts {};
+    std::array<int, numCutSlots> numCutSections {};     // 0 for an inactive slot
+    const SectionCoefficients<float>* hum = nullptr;     // the mains notches, after the low cut
+    int numHumSections = 0;
+    bool midSide = false;
+    int subBlockSize = 0;
+};
+
+//==============================================================================
+/** The part of FilterEngine that owns the per-channel state and runs the
+    kernels: interleaving, the cut and band sections and writing back, for
+    lane groups of one width.
+
+    There is one implementation per InstructionSet, each compiled in its own
+    translation unit with that instruction set enabled (see LaneGroups.h), and
+    FilterEngine picks one at prepare() time. Everything per block goes
+    through a single virtual call, so the dispatch costs nothing measurable.
+*/
+class LaneGroupProcessor
+{
+public:
+    virtual ~LaneGroupProcessor();
+
+    /** Longest sub-block the scratch space holds. */
+    static constexpr int maxFrames = 256;
+
+    // State slots: the bands first, then maxCascadeSections per cut slot and
+    // the hum notches
+    static constexpr int firstHumSection = maxBands + numCutSlots * maxCascadeSections;
+    static constexpr int maxSections = firstHumSection + maxHumHarmonics;
+    static constexpr int firstCutSection (int slot) noexcept  { return maxBands + slot * maxCascadeSections; }
+
+    /** Creates the implementation for an instruction set. It must be supported
+        by this CPU. Not real-time safe; the caller owns the result.
+    */
+    static LaneGroupProcessor* create (InstructionSet isa);
+
+    virtual InstructionSet getInstructionSet() const noexcept = 0;
+    virtual int getLaneWidth() const noexcept = 0;
+
+    /** Allocates silent state for enough lane groups to hold numChannels,
+        and scratch space for numScratchSlots threads to process groups at the
+        same time.
+    */
+    virtual void prepare (int numChannels, int numScratchSlots) = 0;
+
+    /** Frees the state and scratch space; until the next prepare() there are
+        no channels to process.
+    */
+    virtual void release() noexcept = 0;
+
+    virtual int getNumChannels() const noexcept = 0;
+    virtual int getNumGroups() const noexcept = 0;
+
+    virtual void resetSection (int section) noexcept = 0;
+
+    /** Maps the state of the first two lanes of the first group between L/R
+        and M/S.
+    */
+    virtual void convertToMidSide (bool toMidSide) noexcept = 0;
+
+    /** Filters the channels of one lane group in place, one sub-block at a
+        time, using the given scratch slot. Different groups can be processed
+        on different threads at the same time, each with its own slot.
+        sidechain holds numSidechainChannels channels, or is nullptr if no
+        band is keyed.
+    */
+    virtual void process (const LaneGroupSetup& setup, float* const* channels, int numChannels, int numSamples,
+                          const float* const* sidechain, int numSidechainChannels,
+                          int group, int scratchSlot) noexcept = 0;
+};
+
+} // namespace iir
@@ -0,0 +1,276 @@
+#pragma once
+
+#include "Arena.h"
+#include "LaneGroupProcessor.h"
+#include "SectionKernels.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** The LaneGroupProcessor for groups of Lanes channels.
+
+    Only include this from the LaneGroups*.cpp files, each of which
+    instantiates it for one width and is built for the matching instruction
+    set. Keeping every width to its own translation unit is what keeps the
+    wider instructions out of code the baseline build calls: each width's
+    kernels are distinct template instantiations, the few shared helpers
+    they use are force-inlined, and nothing goes through std::vector, whose
+    out-of-line members would be shared with the rest of the plug-in.
+
+    State and scratch live in one Arena, laid out as [group][section] states,
+    [group][band] dynamic states, then one scratch area per thread that can
+    run groups. Each state holds its variables as rows across the lanes and
+    starts on a cache line, so every row a kernel loads is aligned and
+    contiguous, and a group's sections follow each other in the order they
+    run.
+*/
+template <int Lanes>
+class LaneGroups final : public LaneGroupProcessor
+{
+public:
+    explicit LaneGroups (InstructionSet isaToUse) noexcept  : isa (isaToUse) {}
+
+    InstructionSet getInstructionSet() const noexcept override  { return isa; }
+    int getLaneWidth() const noexcept override                  { return Lanes; }
+    int getNumChannels() const noexcept override                { return numGroups * Lanes; }
+    int getNumGroups() const noexcept override                  { return numGroups; }
+
+    void prepare (int numChannels, int numScratchSlots) override
+    {
+        numGroups = (juce::jmax (0, numChannels) + Lanes - 1) / Lanes;
+        numSlots = juce::jmax (1, numScratchSlots);
+        const auto n = (size_t) numGroups;
+
+        arena.allocate (Arena::getBytesFor<State> (n * maxSections)
+                      + Arena::getBytesFor<DynamicState> (n * maxBands)
+                      + (size_t) numSlots * Arena::getBytesFor<Scratch> (1));
+
+        states = arena.take<State> (n * maxSections);
+        dynamicStates = arena.take<DynamicState> (n * maxBands);
+        scratch = arena.take<Scratch> ((size_t) numSlots);
+    }
+
+    void release() noexcept override
+    {
+        arena.release();
+        numGroups = 0;
+        numSlots = 0;
+        states = nullptr;
+        dynamicStates = nullptr;
+        scratch = nullptr;
+    }
+
+    void resetSection (int section) noexcept override
+    {
+        for (int group = 0; group < numGroups; ++group)
+            getState (group, section).reset();
+
+        if (section < maxBands)
+            for (int group = 0; group < numGroups; ++group)
+                getDynamicState (group, section).reset();
+    }
+
+    void convertToMidSide (bool toMidSide) noexcept override
+    {
+        if (numGroups == 0)
+            return;
+
+        // Every topology's state is linear in its input, so the state the first
+        // two lanes would have reached in the other domain is the same matrix
+        // applied to their current state: switching doesn't click
+        const auto scale = toMidSide ? 0.5f : 1.0f;
+
+        const auto convert = [scale] (float* row)
+        {
+            const auto a = row[0], b = row[1];
+            row[0] = scale * (a + b);
+            row[1] = scale * (a - b);
+        };
+
+        for (int section = 0; section < maxSections; ++section)
+            for (auto& row : getState (0, section).z)
+                convert (row);
+
+        // The dynamic bands' SVFs are linear too, but their envelope is a
+        // rectified level and mustn't go negative: both lanes start from the
+        // louder one, which at worst pulls the quieter lane down a little
+        // more for one release time
+        for (int band = 0; band < maxBands; ++band)
+        {
+            auto& z = getDynamicState (0, band).z;
+
+            for (auto row : { 0, 1, 3, 4 })
+                convert (z[row]);
+
+            z[2][0] = z[2][1] = juce::jmax (z[2][0], z[2][1]);
+        }
+    }
+
+    void process (const LaneGroupSetup& setup, float* const* channels, int numChannels, int numSamples,
+                  const float* const* sidechain, int numSidechainChannels,
+                  int group, int scratchSlot) noexcept override
+    {
+        jassert (numChannels <= getNumChannels() && setup.subBlockSize <= maxFrames);
+        jassert (juce::isPositiveAndBelow (group * Lanes, numChannels) && juce::isPositiveAndBelow (scratchSlot, numSlots));
+
+        auto& slot = scratch[scratchSlot];
+        auto* frames = slot.frames[0].data();
+        auto* keyFrames = slot.keyFrames[0].data();
+        auto* heldLane = slot.heldLane;
+
+        const auto firstChannel = group * Lanes;
+        const auto numLanes = juce::jmin (Lanes, numChannels - firstChannel);
+        auto* groupStates = states + group * maxSections;
+
+        for (int start = 0; start < numSamples; start += setup.subBlockSize)
+        {
+            const auto n = juce::jmin (setup.subBlockSize, numSamples - start);
+
+            interleave (channels, numChannels, firstChannel, start, frames, n);
+
+            // Only the first group holds the stereo pair
+            const auto groupIsMidSide = setup.midSide && group == 0;
+
+            if (groupIsMidSide)
+                encodeMidSide (frames, n);
+
+            if (sidechain != nullptr)
+            {
+                // Sidechain channels past the last one repeat the last, so a mono
+                // key drives every channel
+                std::array<const float*, Lanes> keys;
+
+                for (int lane = 0; lane < Lanes; ++lane)
+                    keys[(size_t) lane] = sidechain[juce::jmin (firstChannel + lane, numSidechainChannels - 1)];
+
+                interleave (keys.data(), Lanes, 0, start, keyFrames, n);
+            }
+
+            processCut (setup, lowCut, groupStates, frames, n);
+
+            for (int i = 0; i < setup.numHumSections; ++i)
+                Kernels::process (setup.hum[i], groupStates[firstHumSection + i], frames, n);
+
+            for (int band = 0; band < maxBands; ++band)
+            {
+                const auto& b = setup.bands[band];
+
+                if (! b.enabled)
+                    continue;
+
+                const auto keptLane = ! groupIsMidSide || b.placement == Placement::stereo ? -1
+                                    : b.placement == Placement::mid ? 1 : 0;
+
+                if (keptLane >= 0)
+                    for (int i = 0; i < n; ++i)
+                        heldLane[i] = frames[i * Lanes + keptLane];
+
+                if (setup.dynamic[band])
+                    DynamicKernel::process (setup.dynamicCoefficients[band], getDynamicState (group, band), frames,
+                                            sidechain != nullptr && setup.keyed[band] ? keyFrames : nullptr, n);
+                else
+                    Kernels::process (setup.coefficients[band], groupStates[band], frames, n);
+
+                if (keptLane >= 0)
+                    for (int i = 0; i < n; ++i)
+                        frames[i * Lanes + keptLane] = heldLane[i];
+            }
+
+            processCut (setup, highCut, groupStates, frames, n);
+
+            if (groupIsMidSide)
+                decodeMidSide (frames, n);
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                auto* dest = channels[firstChannel + lane] + start;
+
+                for (int i = 0; i < n; ++i)
+                    dest[i] = frames[i * Lanes + lane];
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    using Kernels = SectionKernels<float, Lanes>;
+    using DynamicKernel = DynamicBandKernel<float, Lanes>;
+    using State = typename Kernels::State;
+    using DynamicState = typename DynamicKernel::State;
+    using Frame = std::array<float, Lanes>;
+
+    // What one thread needs to run a group, on cache lines of its own
+    struct Scratch
+    {
+        alignas (64) Frame frames[maxFrames];
+        alignas (64) Frame keyFrames[maxFrames];
+        alignas (64) float heldLane[maxFrames];
+    };
+
+    State& getState (int group, int section) noexcept                { return states[group * maxSections + section]; }
+    DynamicState& getDynamicState (int group, int band) noexcept    { return dynamicStates[group * maxBands + band]; }
+
+    static void processCut (const LaneGroupSetup& setup, int slot, State* groupStates,
+                            float* frames, int numFrames) noexcept
+    {
+        for (int i = 0; i < setup.numCutSections[(size_t) slot]; ++i)
+            Kernels::process (setup.cuts[(size_t) slot][i], groupStates[firstCutSection (slot) + i], frames, numFrames);
+    }
+
+    static void encodeMidSide (float* frames, int numFrames) noexcept
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* frame = frames + i * Lanes;
+            const auto left = frame[0], right = frame[1];
+            frame[0] = 0.5f * (left + right);
+            frame[1] = 0.5f * (left - right);
+        }
+    }
+
+    static void decodeMidSide (float* frames, int numFrames) noexcept
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* frame = frames + i * Lanes;
+            const auto mid = frame[0], side = frame[1];
+            frame[0] = mid + side;
+            frame[1] = mid - side;
+        }
+    }
+
+    static void interleave (const float* const* channels, int numChannels, int firstChannel,
+                            int start, float* frames, int numFrames) noexcept
+    {
+        for (int lane = 0; lane < Lanes; ++lane)
+        {
+            const auto channel = firstChannel + lane;
+
+            if (channel < numChannels)
+            {
+                const auto* src = channels[channel] + start;
+
+                for (int i = 0; i < numFrames; ++i)
+                    frames[i * Lanes + lane] = src[i];
+            }
+            else
+            {
+                for (int i = 0; i < numFrames; ++i)
+                    frames[i * Lanes + lane] = 0.0f;
+            }
+        }
+    }
+
+    //==============================================================================
+    const InstructionSet isa;
+    Arena arena;
+    int numGroups = 0, numSlots = 0;
+    State* states = nullptr;
+    DynamicState* dynamicStates = nullptr;
+    Scratch* scratch = nullptr;   // one per slot
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LaneGroups)
+};
+
+} // namespace iir
@@ -0,0 +1,13 @@
+#include "LaneGroups.h"
+
+namespace iir
+{
+
+// Built with AVX2 and FMA enabled in optimised configurations (see Source/CMakeLists.txt).
+// Only ever called once the CPU has reported both.
+LaneGroupProcessor* createAvx2LaneGroups()
+{
+    return new LaneGroups<8> (InstructionSet::avx2);
+}
+
+} // namespace iir
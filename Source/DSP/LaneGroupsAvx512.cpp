@@ -0,0 +1,13 @@
+#include "LaneGroups.h"
+
+namespace iir
+{
+
+// Built with AVX-512F/VL, AVX2 and FMA enabled in optimised configurations (see
+// Source/CMakeLists.txt). Only ever called once the CPU has reported all of them.
+LaneGroupProcessor* createAvx512LaneGroups()
+{
+    return new LaneGroups<16> (InstructionSet::avx512);
+}
+
+} // namespace iir
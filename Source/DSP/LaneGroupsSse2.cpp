@@ -0,0 +1,12 @@
+#include "LaneGroups.h"
+
+namespace iir
+{
+
+// Built with the target's baseline flags, so it runs on any CPU the plug-in loads on
+LaneGroupProcessor* createSse2LaneGroups()
+{
+    return new LaneGroups<4> (InstructionSet::sse2);
+}
+
+} // namespace iir
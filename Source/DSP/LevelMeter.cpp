@@ -0,0 +1,166 @@
+#include "LevelMeter.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** The allpass coefficients of a polyphase halfband filter with an elliptic
+    response, after Valenzuela and Constantinides. transition is the width of
+    the transition band as a fraction of the sample rate going out; the
+    stopband attenuation follows from it and the number of coefficients.
+*/
+template <int NumCoefficients>
+static std::array<float, NumCoefficients> designHalfband (double transition) noexcept
+{
+    constexpr auto pi = juce::MathConstants<double>::pi;
+
+    const auto power = [] (double base, int exponent)
+    {
+        auto result = 1.0;
+
+        for (int i = 0; i < exponent; ++i)
+            result *= base;
+
+        return result;
+    };
+
+    auto k = std::tan ((1.0 - transition * 2.0) * pi / 4.0);
+    k *= k;
+
+    const auto kk = std::sqrt (std::sqrt (1.0 - k * k));
+    const auto e = 0.5 * (1.0 - kk) / (1.0 + kk);
+    const auto e4 = e * e * e * e;
+    const auto q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+    const auto order = NumCoefficients * 2 + 1;
+    std::array<float, NumCoefficients> coefficients {};
+
+    for (int index = 0; index < NumCoefficients; ++index)
+    {
+        const auto c = index + 1;
+
+        auto num = 0.0, term = 1.0;
+
+        for (int i = 0, sign = 1; std::abs (term) > 1.0e-100; ++i, sign = -sign)
+        {
+            term = power (q, i * (i + 1)) * std::sin ((i * 2 + 1) * c * pi / order) * sign;
+            num += term;
+        }
+
+        auto den = 0.5;
+        term = 1.0;
+
+        for (int i = 1, sign = -1; std::abs (term) > 1.0e-100; ++i, sign = -sign)
+        {
+            term = power (q, i * i) * std::cos (i * 2 * c * pi / order) * sign;
+            den += term;
+        }
+
+        const auto ww = num * std::sqrt (std::sqrt (q)) / den;
+        const auto wwsq = ww * ww;
+        const auto x = std::sqrt ((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+        coefficients[(size_t) index] = (float) ((1.0 - x) / (1.0 + x));
+    }
+
+    return coefficients;
+}
+
+// The first stage keeps 20 kHz at 44.1 kHz within its passband; the second
+// only has to reject the first stage's images, an octave higher. Designed once
+// when the library loads: the series need more steps than compilers allow
+// for constant evaluation
+static const auto firstStageCoefficients = designHalfband<8> (0.0225);
+static const auto secondStageCoefficients = designHalfband<4> (0.135);
+
+//==============================================================================
+void LevelMeter::prepare (double sampleRate, int newNumChannels) noexcept
+{
+    jassert (sampleRate > 0.0);
+
+    // 300 ms to reach 1 - 1/e of a step, as a one-pole average of the square
+    rmsCoefficient = (float) (1.0 - std::exp (-1.0 / (0.3 * sampleRate)));
+    numChannels.store (juce::jlimit (0, maxChannels, newNumChannels), std::memory_order_relaxed);
+    reset();
+}
+
+void LevelMeter::reset() noexcept
+{
+    for (auto& state : states)
+        state = {};
+
+    for (auto& readout : readouts)
+    {
+        readout.peak.store (0.0f, std::memory_order_relaxed);
+        readout.truePeak.store (0.0f, std::memory_order_relaxed);
+        readout.rms.store (0.0f, std::memory_order_relaxed);
+    }
+}
+
+//==============================================================================
+void LevelMeter::process (const float* const* channels, int numChannelsToMeasure, int numSamples) noexcept
+{
+    numChannelsToMeasure = juce::jmin (numChannelsToMeasure, getNumChannels());
+
+    for (int channel = 0; channel < numChannelsToMeasure; ++channel)
+    {
+        auto& state = states[(size_t) channel];
+        const auto* data = channels[channel];
+
+        // Local copies, so the allpass memories can stay in registers rather
+        // than being stored after every sample in case they alias the input
+        auto first = state.first;
+        auto second = state.second;
+        auto meanSquare = state.meanSquare;
+        auto peak = 0.0f, truePeak = 0.0f;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto x = data[i];
+            peak = juce::jmax (peak, std::abs (x));
+            meanSquare += rmsCoefficient * (x * x - meanSquare);
+
+            float half[2], quarter[4];
+            first.process (firstStageCoefficients, x, half[0], half[1]);
+            second[0].process (secondStageCoefficients, half[0], quarter[0], quarter[1]);
+            second[1].process (secondStageCoefficients, half[1], quarter[2], quarter[3]);
+
+            for (auto y : quarter)
+                truePeak = juce::jmax (truePeak, std::abs (y));
+        }
+
+        state.first = first;
+        state.second = second;
+        state.meanSquare = meanSquare;
+
+        auto& readout = readouts[(size_t) channel];
+        raiseTo (readout.peak, peak);
+        raiseTo (readout.truePeak, truePeak);
+        readout.rms.store (std::sqrt (meanSquare), std::memory_order_relaxed);
+    }
+}
+
+void LevelMeter::raiseTo (std::atomic<float>& held, float value) noexcept
+{
+    // The reader swaps the peak for zero, so this can't just store over it
+    auto current = held.load (std::memory_order_relaxed);
+
+    while (value > current && ! held.compare_exchange_weak (current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+LevelMeter::Reading LevelMeter::read (int channel) noexcept
+{
+    if (! juce::isPositiveAndBelow (channel, maxChannels))
+        return {};
+
+    auto& readout = readouts[(size_t) channel];
+
+    Reading reading;
+    reading.peak = readout.peak.exchange (0.0f, std::memory_order_relaxed);
+    reading.truePeak = readout.truePeak.exchange (0.0f, std::memory_order_relaxed);
+    reading.rms = readout.rms.load (std::memory_order_relaxed);
+    return reading;
+}
+
+} // namespace iir
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace iir
+{
+
+//==============================================================================
+/** Sample peak, RMS and true peak of each output channel.
+
+    The audio thread measures every block it has finished and publishes the
+    results in atomics; a display reads them at its own rate. Peaks are held
+    until they are read, so a display that only looks 15 times a second
+    still sees every one, and each read starts the next hold. Nothing is
+    locked or allocated on either side.
+
+    The true peak is the peak of the signal upsampled four times by two
+    polyphase IIR halfband stages. Each stage is a pair of chains of
+    first-order allpasses that run at the rate going in, one per output
+    phase, so the four output phases cost eight allpasses at the input rate
+    and as many again at twice the rate.
+*/
+class LevelMeter
+{
+public:
+    LevelMeter() = default;
+
+    static constexpr int maxChannels = 8;
+
+    /** The levels of one channel, as linear gains. */
+    struct Reading
+    {
+        float peak = 0.0f;       // highest sample since the last read
+        float truePeak = 0.0f;   // highest inter-sample peak since the last read
+        float rms = 0.0f;        // over roughly the last 300 ms
+    };
+
+    /** Sets the RMS time constant for the sample rate and clears everything.
+        Channels past maxChannels aren't measured.
+    */
+    void prepare (double sampleRate, int numChannels) noexcept;
+
+    void reset() noexcept;
+
+    int getNumChannels() const noexcept  { return numChannels.load (std::memory_order_relaxed); }
+
+    /** Audio thread: measures one block of output. */
+    void process (const float* const* channels, int numChannelsToMeasure, int numSamples) noexcept;
+
+    /** Any one thread besides the audio thread: the levels since the last read. */
+    Reading read (int channel) noexcept;
+
+private:
+    //==============================================================================
+    static constexpr int numFirstStageCoefficients = 8;
+    static constexpr int numSecondStageCoefficients = 4;
+
+    /** The allpass memories of one halfband stage: the inputs and outputs of
+        each allpass, the even ones on the first phase's chain and the odd
+        ones on the second's.
+    */
+    template <int NumCoefficients>
+    struct Upsampler
+    {
+        std::array<float, NumCoefficients> x {}, y {};
+
+        /** Turns one sample into two at twice the rate. */
+        void process (const std::array<float, NumCoefficients>& coefficients, float input,
+                      float& first, float& second) noexcept
+        {
+            auto a = input, b = input;
+
+            for (size_t i = 0; i < (size_t) NumCoefficients; i += 2)
+            {
+                const auto nextA = (a - y[i]) * coefficients[i] + x[i];
+                const auto nextB = (b - y[i + 1]) * coefficients[i + 1] + x[i + 1];
+                x[i] = a;
+                x[i + 1] = b;
+                y[i] = a = nextA;
+                y[i + 1] = b = nextB;
+            }
+
+            first = a;
+            second = b;
+        }
+    };
+
+    struct ChannelState
+    {
+        Upsampler<numFirstStageCoefficients> first;
+        std::array<Upsampler<numSecondStageCoefficients>, 2> second;
+        float meanSquare = 0.0f;
+    };
+
+    // Written by the audio thread, and the peaks taken back by the reader
+    struct alignas (64) Readout
+    {
+        std::atomic<float> peak { 0.0f }, truePeak { 0.0f }, rms { 0.0f };
+    };
+
+    static void raiseTo (std::atomic<float>& held, float value) noexcept;
+
+    //==============================================================================
+    std::array<ChannelState, maxChannels> states;
+    std::array<Readout, maxChannels> readouts;
+    std::atomic<int> numChannels { 0 };
+    float rmsCoefficient = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeter)
+};
+
+} // namespace iir
@@ -0,0 +1,82 @@
+#include "ModulationEngine.h"
+
+namespace iir
+{
+
+//==============================================================================
+void ModulationEngine::prepare (double newSampleRate, int numChannels)
+{
+    jassert (newSampleRate > 0.0);
+
+    sampleRate = newSampleRate;
+    numStates = juce::jmax (0, numChannels);
+    arena.allocate (Arena::getBytesFor<SvfState<float>> ((size_t) numStates));
+    states = arena.take<SvfState<float>> ((size_t) numStates);
+
+    lfo.prepare (sampleRate);
+    envelope.prepare (sampleRate);
+    setSettings (settings);
+}
+
+void ModulationEngine::release() noexcept
+{
+    arena.release();
+    states = nullptr;
+    numStates = 0;
+}
+
+void ModulationEngine::reset() noexcept
+{
+    for (int i = 0; i < numStates; ++i)
+        states[i].reset();
+
+    lfo.reset();
+    envelope.reset();
+}
+
+void ModulationEngine::setSettings (const ModulationSettings& newSettings) noexcept
+{
+    if (newSettings.enabled && ! settings.enabled)
+        reset();
+
+    settings = newSettings;
+    prototype = SvfCoefficients<float>::Prototype::make (settings.type, settings.gainDb, sampleRate);
+    lfo.setFrequency (settings.lfoRateHz);
+    envelope.setTimes (settings.envelopeAttackMs, settings.envelopeReleaseMs);
+}
+
+//==============================================================================
+void ModulationEngine::process (float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (! settings.enabled)
+        return;
+
+    jassert (numChannels <= numStates);
+    numChannels = juce::jmin (numChannels, numStates);
+
+    const auto baseCutoff = settings.frequency;
+    const auto baseQ = settings.q;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto level = 0.0f;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            level = juce::jmax (level, std::abs (channels[channel][i]));
+
+        const auto env = envelope.process (level);
+        const auto mod = lfo.getNextSample();
+
+        const auto cutoffOctaves = mod * settings.lfoToCutoff + env * settings.envelopeToCutoff;
+        const auto qOctaves      = mod * settings.lfoToQ      + env * settings.envelopeToQ;
+
+        const auto c = SvfCoefficients<float>::design (prototype,
+                                                       baseCutoff * FastMath::exp2 (cutoffOctaves),
+                                                       baseQ * FastMath::exp2 (qOctaves));
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            channels[channel][i] = states[channel].processSample (c, channels[channel][i]);
+    }
+}
+
+} // namespace iir
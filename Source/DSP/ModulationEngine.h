@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Arena.h"
+#include "ModulationSources.h"
+#include "StateVariableFilter.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** A TPT state-variable filter whose cutoff and Q follow an LFO and an
+    envelope follower, with the coefficients redesigned on every sample.
+
+    The envelope is detected from the loudest channel, so all channels share
+    one modulation signal and one coefficient set per sample.
+*/
+class ModulationEngine
+{
+public:
+    ModulationEngine() = default;
+
+    /** Allocates state for the given layout. Not real-time safe. */
+    void prepare (double newSampleRate, int numChannels);
+
+    /** Frees the per-channel state. Until the next prepare(), process() does nothing. */
+    void release() noexcept;
+
+    void reset() noexcept;
+
+    void setSettings (const ModulationSettings& newSettings) noexcept;
+
+    /** Filters the given channels in place. Does nothing while disabled. */
+    void process (float* const* channels, int numChannels, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    double sampleRate = 44100.0;
+    ModulationSettings settings;
+    SvfCoefficients<float>::Prototype prototype;
+    Lfo lfo;
+    EnvelopeFollower envelope;
+    Arena arena;
+    SvfState<float>* states = nullptr;
+    int numStates = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModulationEngine)
+};
+
+} // namespace iir
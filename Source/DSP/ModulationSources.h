@@ -0,0 +1,129 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace iir
+{
+
+//==============================================================================
+/** A sine LFO built as a rotating phasor, so each sample costs four multiplies
+    instead of a call to std::sin.
+
+    The phasor renormalises itself every renormaliseInterval samples to stop the
+    amplitude from drifting. Counting samples rather than blocks keeps the
+    output identical however the host slices the stream, and keeps the cost
+    per sample flat when blocks are tiny.
+*/
+class Lfo
+{
+public:
+    void prepare (double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        setFrequency (frequency);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        sine = 0.0f;
+        cosine = 1.0f;
+        samplesUntilRenormalise = renormaliseInterval;
+    }
+
+    void setFrequency (float newFrequency) noexcept
+    {
+        frequency = newFrequency;
+        const auto w = juce::MathConstants<double>::twoPi * (double) frequency / sampleRate;
+        stepCos = (float) std::cos (w);
+        stepSin = (float) std::sin (w);
+    }
+
+    /** Returns the next value in [-1, 1]. */
+    float getNextSample() noexcept
+    {
+        const auto out = sine;
+        const auto s = sine * stepCos + cosine * stepSin;
+        cosine = cosine * stepCos - sine * stepSin;
+        sine = s;
+
+        if (--samplesUntilRenormalise == 0)
+        {
+            samplesUntilRenormalise = renormaliseInterval;
+            renormalise();
+        }
+
+        return out;
+    }
+
+    static constexpr int renormaliseInterval = 256;
+
+    void renormalise() noexcept
+    {
+        const auto magnitude = std::sqrt (sine * sine + cosine * cosine);
+
+        if (magnitude > 0.0f)
+        {
+            sine /= magnitude;
+            cosine /= magnitude;
+        }
+        else
+        {
+            reset();
+        }
+    }
+
+private:
+    double sampleRate = 44100.0;
+    float frequency = 1.0f;
+    float sine = 0.0f, cosine = 1.0f, stepCos = 1.0f, stepSin = 0.0f;
+    int samplesUntilRenormalise = renormaliseInterval;
+};
+
+//==============================================================================
+/** A peak envelope follower: a one-pole lowpass on the rectified input with
+    separate attack and release times.
+*/
+class EnvelopeFollower
+{
+public:
+    void prepare (double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        setTimes (attackMs, releaseMs);
+        reset();
+    }
+
+    void reset() noexcept  { envelope = 0.0f; }
+
+    void setTimes (float newAttackMs, float newReleaseMs) noexcept
+    {
+        attackMs = newAttackMs;
+        releaseMs = newReleaseMs;
+        attack  = makeCoefficient (attackMs);
+        release = makeCoefficient (releaseMs);
+    }
+
+    /** Feeds one (already rectified) sample and returns the envelope. */
+    float process (float level) noexcept
+    {
+        const auto coefficient = level > envelope ? attack : release;
+        envelope = level + coefficient * (envelope - level);
+        return envelope;
+    }
+
+    float getEnvelope() const noexcept  { return envelope; }
+
+private:
+    float makeCoefficient (float timeMs) const noexcept
+    {
+        const auto samples = (double) timeMs * 0.001 * sampleRate;
+        return samples > 0.0 ? (float) std::exp (-1.0 / samples) : 0.0f;
+    }
+
+    double sampleRate = 44100.0;
+    float attackMs = 5.0f, releaseMs = 100.0f;
+    float attack = 0.0f, release = 0.0f, envelope = 0.0f;
+};
+
+} // namespace iir
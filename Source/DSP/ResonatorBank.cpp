@@ -0,0 +1,223 @@
+#include "ResonatorBank.h"
+
+namespace iir
+{
+
+// Defined in ResonatorBankSse2.cpp, ResonatorBankAvx2.cpp and ResonatorBankAvx512.cpp
+ResonatorBank::Kernel getSse2ResonatorKernel();
+ResonatorBank::Kernel getAvx2ResonatorKernel();
+ResonatorBank::Kernel getAvx512ResonatorKernel();
+
+static ResonatorBank::Kernel getKernel (InstructionSet isa) noexcept
+{
+    switch (isa)
+    {
+        case InstructionSet::sse2:    return getSse2ResonatorKernel();
+        case InstructionSet::avx2:    return getAvx2ResonatorKernel();
+        case InstructionSet::avx512:  return getAvx512ResonatorKernel();
+    }
+
+    jassertfalse;
+    return getSse2ResonatorKernel();
+}
+
+/** Every bank has enough modes to fill any register, so the widest set the
+    CPU supports wins, unless one is forced for testing.
+*/
+static InstructionSet chooseInstructionSet() noexcept
+{
+    auto forced = InstructionSet::sse2;
+
+    if (InstructionSets::getForcedByEnvironment (forced) && InstructionSets::isSupported (forced))
+        return forced;
+
+    for (auto isa : { InstructionSet::avx512, InstructionSet::avx2 })
+        if (InstructionSets::isSupported (isa))
+            return isa;
+
+    return InstructionSet::sse2;
+}
+
+static size_t getNumPaddedModes (int numModes) noexcept
+{
+    constexpr auto lanes = ResonatorCoefficients::maxLanes;
+    return (size_t) ((numModes + lanes - 1) / lanes * lanes);
+}
+
+//==============================================================================
+ResonatorBank::~ResonatorBank() = default;
+
+juce::Result ResonatorBank::parseModes (const juce::String& text, std::vector<Mode>& result)
+{
+    std::vector<Mode> parsed;
+    juce::StringArray lines;
+    lines.addLines (text);
+
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        const auto line = lines[i].trim();
+
+        if (line.isEmpty() || line.startsWithChar ('#'))
+            continue;
+
+        juce::StringArray fields;
+        fields.addTokens (line, " \t,", {});
+        fields.removeEmptyStrings();
+
+        const auto where = "Line " + juce::String (i + 1) + ": ";
+
+        if (fields.size() != 3)
+            return juce::Result::fail (where + "expected frequency, damping and gain");
+
+        Mode mode { fields[0].getFloatValue(), fields[1].getFloatValue(), fields[2].getFloatValue() };
+
+        if (mode.frequency <= 0.0f || mode.damping <= 0.0f)
+            return juce::Result::fail (where + "frequency and damping must be positive");
+
+        if ((int) parsed.size() == maxModes)
+            return juce::Result::fail (where + "more than " + juce::String (maxModes) + " modes");
+
+        parsed.push_back (mode);
+    }
+
+    if (parsed.empty())
+        return juce::Result::fail ("No modes in the table");
+
+    result = std::move (parsed);
+    return juce::Result::ok();
+}
+
+//==============================================================================
+void ResonatorBank::prepare (double newSampleRate, int numChannels)
+{
+    jassert (newSampleRate > 0.0);
+
+    kernel = getKernel (chooseInstructionSet());
+    numStateChannels = juce::jmax (0, numChannels);
+    stateArena.allocate (Arena::getBytesFor<float> ((size_t) numStateChannels * 2 * getNumPaddedModes (maxModes)));
+    states = stateArena.take<float> ((size_t) numStateChannels * 2 * getNumPaddedModes (maxModes));
+    current = nullptr;
+
+    const juce::ScopedLock sl (designLock);
+    sampleRate = newSampleRate;
+    publish();
+}
+
+void ResonatorBank::release() noexcept
+{
+    stateArena.release();
+    states = nullptr;
+    numStateChannels = 0;
+}
+
+void ResonatorBank::setModes (std::vector<Mode> newModes)
+{
+    jassert ((int) newModes.size() <= maxModes);
+    newModes.resize (juce::jmin (newModes.size(), (size_t) maxModes));
+
+    const juce::ScopedLock sl (designLock);
+    modes = std::move (newModes);
+    numModes.store ((int) modes.size());
+    publish();
+}
+
+void ResonatorBank::publish()
+{
+    const auto numPadded = getNumPaddedModes ((int) modes.size());
+
+    auto design = std::make_unique<Design>();
+    design->arena.allocate (3 * Arena::getBytesFor<float> (numPadded));
+
+    auto* b = design->arena.take<float> (numPadded);
+    auto* a1 = design->arena.take<float> (numPadded);
+    auto* a2 = design->arena.take<float> (numPadded);
+    auto slowestDamping = 0.0;
+
+    for (size_t i = 0; i < modes.size(); ++i)
+    {
+        const auto& mode = modes[i];
+
+        // Modes at or above Nyquist stay silent
+        if (mode.frequency >= 0.49 * sampleRate)
+            continue;
+
+        const auto r = std::exp (-(double) mode.damping / sampleRate);
+        const auto w = juce::MathConstants<double>::twoPi * (double) mode.frequency / sampleRate;
+
+        // |H| at the mode's own frequency is 1 / ((1 - r) |1 - r e^-2jw|),
+        // so this makes gain the mode's peak gain
+        const auto farPole = std::hypot (1.0 - r * std::cos (2.0 * w), r * std::sin (2.0 * w));
+
+        b[i]  = (float) ((double) mode.gain * (1.0 - r) * farPole);
+        a1[i] = (float) (2.0 * r * std::cos (w));
+        a2[i] = (float) (-r * r);
+
+        if (slowestDamping == 0.0 || mode.damping < slowestDamping)
+            slowestDamping = mode.damping;
+    }
+
+    // The envelope is e^(-damping t), which is down 60 dB at ln (1000) / damping
+    tailSeconds.store (slowestDamping > 0.0 ? std::log (1000.0) / slowestDamping : 0.0);
+
+    design->coefficients = { b, a1, a2, (int) modes.size() };
+    published.store (design.get());
+    designs.push_back (std::move (design));
+
+    // Anything the audio thread can no longer reach goes
+    designs.erase (std::remove_if (designs.begin(), designs.end(), [this] (const auto& d)
+                   {
+                       return d.get() != published.load() && d.get() != hazard.load();
+                   }),
+                   designs.end());
+}
+
+//==============================================================================
+const ResonatorBank::Design* ResonatorBank::acquire() noexcept
+{
+    // As in CascadeDesignService: once the hazard is seen to match, the owner
+    // side is guaranteed to see it before freeing anything
+    for (;;)
+    {
+        auto* design = published.load();
+        hazard.store (design);
+
+        if (published.load() == design)
+            return design;
+    }
+}
+
+void ResonatorBank::reset() noexcept
+{
+    if (states != nullptr)
+        std::fill (states, states + (size_t) numStateChannels * 2 * getNumPaddedModes (maxModes), 0.0f);
+}
+
+void ResonatorBank::process (float* const* channels, int numChannels, int numSamples, float mix) noexcept
+{
+    if (states == nullptr)
+        return;
+
+    auto* design = acquire();
+
+    if (design != current)
+    {
+        current = design;
+        reset();
+    }
+
+    if (current == nullptr || current->coefficients.numModes == 0)
+        return;
+
+    jassert (numChannels <= numStateChannels);
+    numChannels = juce::jmin (numChannels, numStateChannels);
+
+    const auto stride = getNumPaddedModes (maxModes);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* y1 = states + (size_t) ch * 2 * stride;
+        kernel (current->coefficients, y1, y1 + stride, channels[ch], numSamples, mix);
+    }
+}
+
+} // namespace iir
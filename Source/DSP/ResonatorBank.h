@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Arena.h"
+#include "InstructionSet.h"
+#include "ResonatorKernels.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** A bank of up to maxModes two-pole resonators run in parallel on every
+    channel, for modal synthesis and body resonances.
+
+    The modes come from a table of frequency, damping and gain, loaded with
+    setModes() from any thread but the audio thread. It is designed straight
+    away into coefficient arrays, one per coefficient, and handed to the
+    audio thread the same way CascadeDesignService hands over cascades:
+    through an atomic pointer guarded by a hazard pointer, so loading a table
+    never blocks process(). A new table starts from silence.
+
+    The kernels run across the modes rather than across channels, so a
+    channel's resonators fill the widest vector registers this CPU has
+    whatever the channel count; like the lane groups, they are built once per
+    InstructionSet.
+*/
+class ResonatorBank
+{
+public:
+    ResonatorBank() = default;
+    ~ResonatorBank();
+
+    static constexpr int maxModes = 1024;
+
+    /** One resonator: its frequency in Hz, how fast it dies away, as the
+        exponential decay rate of its envelope in 1/s, and its gain at its
+        own frequency.
+    */
+    struct Mode
+    {
+        float frequency = 0.0f, damping = 0.0f, gain = 0.0f;
+    };
+
+    using Kernel = void (*) (const ResonatorCoefficients&, float* y1, float* y2,
+                             float* data, int numSamples, float mix) noexcept;
+
+    /** Reads a mode table: one mode per line as frequency, damping and gain,
+        separated by spaces, tabs or commas. Blank lines and lines starting
+        with '#' are skipped.
+    */
+    static juce::Result parseModes (const juce::String& text, std::vector<Mode>& result);
+
+    /** Allocates the state for the given layout, picks the kernels and
+        redesigns the current table for the sample rate. Not real-time safe.
+    */
+    void prepare (double newSampleRate, int numChannels);
+
+    /** Frees the state. Until the next prepare(), process() does nothing. */
+    void release() noexcept;
+
+    /** Designs the modes and hands them to the audio thread. Not real-time
+        safe; must not be called from the audio thread.
+    */
+    void setModes (std::vector<Mode> newModes);
+
+    /** The number of modes in the current table. */
+    int getNumModes() const noexcept  { return numModes.load(); }
+
+    /** How long the slowest mode below Nyquist takes to fall by 60 dB once
+        the input stops, in seconds. Safe to call from any thread.
+    */
+    double getTailSeconds() const noexcept  { return tailSeconds.load(); }
+
+    /** Audio thread: clears the resonators' state. */
+    void reset() noexcept;
+
+    /** Audio thread: runs the bank over each channel and mixes its output
+        with the input, mix being the proportion of resonators.
+    */
+    void process (float* const* channels, int numChannels, int numSamples, float mix) noexcept;
+
+private:
+    //==============================================================================
+    struct Design
+    {
+        Arena arena;
+        ResonatorCoefficients coefficients;
+    };
+
+    void publish();
+    const Design* acquire() noexcept;
+
+    // Owner side, under designLock
+    juce::CriticalSection designLock;
+    double sampleRate = 44100.0;
+    std::vector<Mode> modes;
+    std::vector<std::unique_ptr<Design>> designs;
+    std::atomic<int> numModes { 0 };
+    std::atomic<double> tailSeconds { 0.0 };
+
+    std::atomic<const Design*> published { nullptr };
+    std::atomic<const Design*> hazard { nullptr };
+
+    // Audio thread
+    Kernel kernel = nullptr;
+    const Design* current = nullptr;
+    Arena stateArena;
+    float* states = nullptr;      // [channel][y1 | y2][mode]
+    int numStateChannels = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResonatorBank)
+};
+
+} // namespace iir
@@ -0,0 +1,14 @@
+#include "ResonatorBank.h"
+#include "ResonatorKernels.h"
+
+namespace iir
+{
+
+// Built with AVX2 and FMA enabled in optimised configurations (see Source/CMakeLists.txt).
+// Only ever called once the CPU has reported both.
+ResonatorBank::Kernel getAvx2ResonatorKernel()
+{
+    return &ResonatorKernels<8>::process;
+}
+
+} // namespace iir
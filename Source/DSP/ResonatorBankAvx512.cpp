@@ -0,0 +1,14 @@
+#include "ResonatorBank.h"
+#include "ResonatorKernels.h"
+
+namespace iir
+{
+
+// Built with AVX-512F/VL, AVX2 and FMA enabled in optimised configurations (see
+// Source/CMakeLists.txt). Only ever called once the CPU has reported all of them.
+ResonatorBank::Kernel getAvx512ResonatorKernel()
+{
+    return &ResonatorKernels<16>::process;
+}
+
+} // namespace iir
@@ -0,0 +1,13 @@
+#include "ResonatorBank.h"
+#include "ResonatorKernels.h"
+
+namespace iir
+{
+
+// Built with the target's baseline flags, so it runs on any CPU the plug-in loads on
+ResonatorBank::Kernel getSse2ResonatorKernel()
+{
+    return &ResonatorKernels<4>::process;
+}
+
+} // namespace iir
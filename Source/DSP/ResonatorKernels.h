@@ -0,0 +1,84 @@
+#pragma once
+
+#include "SectionKernels.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** The coefficients of a bank of two-pole resonators, one array per
+    coefficient. Every array holds numModes values padded with silent modes
+    to a multiple of maxLanes, and starts on a cache line.
+
+    Each mode runs y = b x + a1 y1 + a2 y2.
+*/
+struct ResonatorCoefficients
+{
+    static constexpr int maxLanes = 16;
+
+    const float* b = nullptr;
+    const float* a1 = nullptr;
+    const float* a2 = nullptr;
+    int numModes = 0;
+};
+
+//==============================================================================
+/** Runs every mode of a bank over one channel and mixes their sum with the
+    input.
+
+    The modes are the lanes here: each sample is fed to Lanes resonators at a
+    time, with the coefficients and both state rows read as contiguous
+    vectors, and their outputs summed lane by lane. A thousand modes' worth of
+    coefficients and state fits in L1, and the modes don't depend on each
+    other, so the loop is bound by throughput rather than by the feedback
+    latency a mode-at-a-time loop over the samples would wait on.
+*/
+template <int Lanes>
+struct ResonatorKernels
+{
+    static_assert (ResonatorCoefficients::maxLanes % Lanes == 0);
+
+    /** y1 and y2 hold the state of every mode for this channel. */
+    static void process (const ResonatorCoefficients& c, float* y1, float* y2,
+                         float* data, int numSamples, float mix) noexcept
+    {
+        const auto numPadded = (c.numModes + Lanes - 1) / Lanes * Lanes;
+        processModes (c.b, c.a1, c.a2, y1, y2, numPadded, data, numSamples, mix);
+    }
+
+private:
+    // None of the arrays overlap. Unless the parameters say so, the compiler
+    // has to assume a store to the state can change the coefficients, and
+    // leaves the mode loop scalar
+    static void processModes (const float* __restrict b, const float* __restrict a1, const float* __restrict a2,
+                              float* __restrict y1, float* __restrict y2, int numPadded,
+                              float* data, int numSamples, float mix) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto x = data[i];
+            std::array<float, Lanes> sum {};
+
+            for (int m = 0; m < numPadded; m += Lanes)
+            {
+                IIR_LANE_LOOP
+                for (int l = 0; l < Lanes; ++l)
+                {
+                    const auto y = b[m + l] * x + a1[m + l] * y1[m + l] + a2[m + l] * y2[m + l];
+                    y2[m + l] = y1[m + l];
+                    y1[m + l] = y;
+                    sum[(size_t) l] += y;
+                }
+            }
+
+            auto wet = 0.0f;
+
+            for (int l = 0; l < Lanes; ++l)
+                wet += sum[(size_t) l];
+
+            data[i] = x + mix * (wet - x);
+        }
+    }
+};
+
+} // namespace iir
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "Topologies.h"
+
+/** Goes in front of every loop over the lanes of a frame.
+
+    GCC unrolls a lane loop of up to 8 lanes completely before the vectoriser
+    sees it, and then leaves the unrolled body scalar. With 4 lanes that
+    scalar code, which keeps the state in registers, is still the faster of
+    the two; with 8 it takes nearly twice as long as the vector loop. So the
+    translation units built for AVX2 and up keep the loop rolled.
+*/
+#if JUCE_GCC && defined (__AVX2__)
+ #define IIR_LANE_LOOP _Pragma ("GCC unroll 1")
+#else
+ #define IIR_LANE_LOOP
+#endif
+
+namespace iir
+{
+
+//==============================================================================
+/** Filter state for one band across a group of lanes (channels).
+
+    No topology needs more than four state variables, so every topology uses
+    the same storage: one row per variable, one column per lane. The lane loop
+    in the kernels then reads each row contiguously. Each state starts on its
+    own cache line, so with 4 float lanes it is exactly one line.
+*/
+template <typename SampleType, int Lanes>
+struct SectionState
+{
+    alignas (64) SampleType z[4][Lanes] {};
+
+    void reset() noexcept  { *this = {}; }
+};
+
+//==============================================================================
+/** Runs one second-order section over lane-interleaved samples, i.e. data
+    holds numSamples frames of Lanes values each.
+
+    The inner loops run across lanes with no dependency between them, which is
+    what lets the compiler put each frame in a single SIMD register.
+*/
+template <typename SampleType, int Lanes>
+struct SectionKernels
+{
+    using Coefficients = SectionCoefficients<SampleType>;
+    using State = SectionState<SampleType, Lanes>;
+
+    static void process (const Coefficients& c, State& s, SampleType* data, int numSamples) noexcept
+    {
+        switch (c.topology)
+        {
+            case Topology::directForm1:            processDirectForm1 (c.biquad, s, data, numSamples); break;
+            case Topology::transposedDirectForm2:  processTransposedDirectForm2 (c.biquad, s, data, numSamples); break;
+            case Topology::stateVariable:          processStateVariable (c.svf, s, data, numSamples); break;
+            case Topology::normalisedLattice:      processLattice (c.lattice, s, data, numSamples); break;
+            case Topology::coupledForm:            processStateSpace (c.stateSpace, s, data, numSamples); break;
+            case Topology::errorFeedback:          processErrorFeedback (c.errorFeedback, s, data, numSamples); break;
+        }
+    }
+
+    //==============================================================================
+    static void processDirectForm1 (const BiquadCoefficients<SampleType>& c, State& s,
+                                    SampleType* data, int numSamples) noexcept
+    {
+        // Work on a local copy so the state can live in registers: data can't alias it
+        auto local = s;
+        auto& x1 = local.z[0];
+        auto& x2 = local.z[1];
+        auto& y1 = local.z[2];
+        auto& y2 = local.z[3];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = data + i * Lanes;
+
+            IIR_LANE_LOOP
+            for (int l = 0; l < Lanes; ++l)
+            {
+                const auto x = frame[l];
+                const auto y = c.b0 * x + c.b1 * x1[l] + c.b2 * x2[l] - c.a1 * y1[l] - c.a2 * y2[l];
+                x2[l] = x1[l];  x1[l] = x;
+                y2[l] = y1[l];  y1[l] = y;
+                frame[l] = y;
+            }
+        }
+
+        s = local;
+    }
+
+    static void processTransposedDirectForm2 (const BiquadCoefficients<SampleType>& c, State& s,
+                                              SampleType* data, int numSamples) noexcept
+    {
+        auto local = s;
+        auto& z1 = local.z[0];
+        auto& z2 = local.z[1];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = data + i * Lanes;
+
+            IIR_LANE_LOOP
+            for (int l = 0; l < Lanes; ++l)
+            {
+                const auto x = frame[l];
+                const auto y = c.b0 * x + z1[l];
+                z1[l] = c.b1 * x - c.a1 * y + z2[l];
+                z2[l] = c.b2 * x - c.a2 * y;
+                frame[l] = y;
+            }
+        }
+
+        s = local;
+    }
+
+    static void processStateVariable (const SvfCoefficients<SampleType>& c, State& s,
+                                      SampleType* data, int numSamples) noexcept
+    {
+        auto local = s;
+        auto& ic1 = local.z[0];
+        auto& ic2 = local.z[1];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = data + i * Lanes;
+
+            IIR_LANE_LOOP
+            for (int l = 0; l < Lanes; ++l)
+            {
+                const auto x = frame[l];
+                const auto v3 = x - ic2[l];
+                const auto v1 = c.a1 * ic1[l] + c.a2 * v3;
+                const auto v2 = ic2[l] + c.a2 * ic1[l] + c.a3 * v3;
+                ic1[l] = 2 * v1 - ic1[l];
+                ic2[l] = 2 * v2 - ic2[l];
+                frame[l] = c.m0 * x + c.m1 * v1 + c.m2 * v2;
+            }
+        }
+
+        s = local;
+    }
+
+    static void processLattice (const LatticeCoefficients<SampleType>& c, State& s,
+                                SampleType* data, int numSamples) noexcept
+    {
+        auto local = s;
+        auto& g0Prev = local.z[0];
+        auto& g1Prev = local.z[1];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = data + i * Lanes;
+
+            IIR_LANE_LOOP
+            for (int l = 0; l < Lanes; ++l)
+            {
+                const auto x  = frame[l];
+                const auto f1 = c.c2 * x  - c.k2 * g1Prev[l];
+                const auto g2 = c.k2 * x  + c.c2 * g1Prev[l];
+                const auto f0 = c.c1 * f1 - c.k1 * g0Prev[l];
+                const auto g1 = c.k1 * f1 + c.c1 * g0Prev[l];
+                g0Prev[l] = f0;
+                g1Prev[l] = g1;
+                frame[l] = c.v0 * f0 + c.v1 * g1 + c.v2 * g2;
+            }
+        }
+
+        s = local;
+    }
+
+    static void processStateSpace (const StateSpaceCoefficients<SampleType>& c, State& s,
+                                   SampleType* data, int numSamples) noexcept
+    {
+        auto local = s;
+        auto& s1 = local.z[0];
+        auto& s2 = local.z[1];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = data + i * Lanes;
+
+            IIR_LANE_LOOP
+            for (int l = 0; l < Lanes; ++l)
+            {
+                const auto x = frame[l];
+                const auto y = c.c1 * s1[l] + c.c2 * s2[l] + c.d * x;
+                const auto n1 = c.a11 * s1[l] + c.a12 * s2[l] + c.b1 * x;
+                const auto n2 = c.a21 * s1[l] + c.a22 * s2[l] + c.b2 * x;
+                s1[l] = n1;
+                s2[l] = n2;
+                frame[l] = y;
+            }
+        }
+
+        s = local;
+    }
+
+    static void processErrorFeedback (const ErrorFeedbackCoefficients<SampleType>& c, State& s,
+                                      SampleType* data, int numSamples) noexcept
+    {
+        auto local = s;
+        auto& r1    = local.z[0];    // e1 x[n-1] + e2 x[n-2], ready for this sample
+        auto& r2    = local.z[1];    // e2 x[n-1]
+        auto& w1    = local.z[2];    // recursive part of the previous output
+        auto& carry = local.z[3];    // unrounded increment of the previous sample
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = data + i * Lanes;
+
+            IIR_LANE_LOOP
+            for (int l = 0; l < Lanes; ++l)
+            {
+                const auto x = frame[l];
+                const auto increment = r1[l] + (carry[l] - c.d2 * carry[l]) - c.feedback * w1[l];
+                const auto w = w1[l] + increment;
+                r1[l] = c.e1 * x + r2[l];
+                r2[l] = c.e2 * x;
+                w1[l] = w;
+                carry[l] = increment;
+                frame[l] = c.b0 * x + w;
+            }
+        }
+
+        s = local;
+    }
+};
+
+} // namespace iir
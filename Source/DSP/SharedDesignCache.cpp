@@ -0,0 +1,60 @@
+#include "SharedDesignCache.h"
+
+namespace iir
+{
+
+//==============================================================================
+SharedDesignCache::SharedDesignCache()
+    : entries (std::make_shared<const Entries>())
+{
+}
+
+SharedDesignCache::DesignPtr SharedDesignCache::find (const CascadeSpec& spec) const
+{
+    return find (*std::atomic_load (&entries), spec);
+}
+
+SharedDesignCache::DesignPtr SharedDesignCache::find (const Entries& snapshot, const CascadeSpec& spec)
+{
+    for (const auto& e : snapshot)
+        if (e.spec == spec)
+            if (auto design = e.design.lock())
+                return design;
+
+    return {};
+}
+
+SharedDesignCache::DesignPtr SharedDesignCache::insert (DesignPtr design)
+{
+    jassert (design != nullptr);
+
+    const juce::ScopedLock sl (writeLock);
+    const auto current = std::atomic_load (&entries);
+
+    if (auto existing = find (*current, design->spec))
+        return existing;
+
+    auto next = std::make_shared<Entries> (*current);
+
+    // Reuse the first entry whose design has been freed before growing
+    auto expired = std::find_if (next->begin(), next->end(),
+                                 [] (const Entry& e) { return e.design.expired(); });
+
+    if (expired != next->end())
+        *expired = { design->spec, design };
+    else
+        next->push_back ({ design->spec, design });
+
+    std::atomic_store (&entries, std::shared_ptr<const Entries> (std::move (next)));
+    return design;
+}
+
+int SharedDesignCache::getNumDesigns() const
+{
+    const auto snapshot = std::atomic_load (&entries);
+
+    return (int) std::count_if (snapshot->begin(), snapshot->end(),
+                                [] (const Entry& e) { return ! e.design.expired(); });
+}
+
+} // namespace iir
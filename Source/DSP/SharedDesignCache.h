@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CascadeDesigner.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** Cascade designs shared by every plugin instance in the process.
+
+    Hold it through a juce::SharedResourcePointer: the first instance creates
+    it and the last one to go deletes it. Designs are immutable and handed out
+    as shared pointers, so any number of instances can run the same design and
+    it is freed once the last of them lets go of it. The cache itself only
+    keeps weak references, so it never holds memory nobody is using.
+
+    Only the designer threads touch it; the audio threads keep reading their
+    own published pointers. Lookups read an immutable snapshot of the entries
+    and never block. An insert copies the snapshot, changes the copy and
+    publishes it, and inserts are serialised by a lock that only they take.
+*/
+class SharedDesignCache
+{
+public:
+    SharedDesignCache();
+
+    using DesignPtr = std::shared_ptr<const CascadeDesign>;
+
+    /** Returns the design for the spec if any instance still holds one. */
+    DesignPtr find (const CascadeSpec& spec) const;
+
+    /** Adds a freshly computed design. If another instance finished the same
+        spec in the meantime, that design is returned instead and the new one
+        can be dropped, so equal specs always end up sharing one design.
+    */
+    DesignPtr insert (DesignPtr design);
+
+    /** Number of distinct designs alive in the process. */
+    int getNumDesigns() const;
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        CascadeSpec spec;
+        std::weak_ptr<const CascadeDesign> design;
+    };
+
+    using Entries = std::vector<Entry>;
+
+    static DesignPtr find (const Entries& snapshot, const CascadeSpec& spec);
+
+    std::shared_ptr<const Entries> entries;   // replaced whole, read and written with std::atomic_load/store
+    juce::CriticalSection writeLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedDesignCache)
+};
+
+} // namespace iir
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "DesignTables.h"
+#include "FastMath.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** Coefficients for a topology-preserving-transform state-variable filter.
+
+    This is the trapezoidal SVF from Zavalishin / Simper. The output is
+    m0 * x + m1 * bandpass + m2 * lowpass, which covers every FilterType. Unlike
+    a biquad, the structure stays well behaved when its coefficients change every
+    sample, and a redesign costs one tan approximation and one division.
+*/
+template <typename SampleType>
+struct SvfCoefficients
+{
+    SampleType k = 1, a1 = 1, a2 = 0, a3 = 0;
+    SampleType m0 = 1, m1 = 0, m2 = 0;
+
+    /** The part of a design that stays fixed while cutoff and Q move. */
+    struct Prototype
+    {
+        FilterType type = FilterType::lowPass;
+        SampleType A = 1, sqrtA = 1;
+        SampleType piOverSampleRate = 0, maxFrequency = 0;
+
+        static Prototype make (FilterType type, float gainDb, double sampleRate) noexcept
+        {
+            jassert (sampleRate > 0.0);
+
+            Prototype p;
+            p.type = type;
+            p.A = (SampleType) DesignTables::getAmplitude (gainDb);
+            p.sqrtA = std::sqrt (p.A);
+            p.piOverSampleRate = (SampleType) (juce::MathConstants<double>::pi / sampleRate);
+            p.maxFrequency = (SampleType) (sampleRate * 0.49);
+            return p;
+        }
+    };
+
+    /** Cheap enough to call once per sample. */
+    static SvfCoefficients design (const Prototype& p, SampleType frequency, SampleType q) noexcept
+    {
+        frequency = juce::jlimit ((SampleType) 1, p.maxFrequency, frequency);
+        q = juce::jmax ((SampleType) 1.0e-3, q);
+
+        auto g = FastMath::tan (frequency * p.piOverSampleRate);
+        auto k = (SampleType) 1 / q;
+
+        SvfCoefficients c;
+
+        switch (p.type)
+        {
+            case FilterType::lowPass:    c.m0 = 0;  c.m1 = 0;   c.m2 = 1;  break;
+            case FilterType::highPass:   c.m0 = 1;  c.m1 = -k;  c.m2 = -1; break;
+            case FilterType::bandPass:   c.m0 = 0;  c.m1 = k;   c.m2 = 0;  break;
+            case FilterType::notch:      c.m0 = 1;  c.m1 = -k;  c.m2 = 0;  break;
+
+            case FilterType::peak:
+                k /= p.A;
+                c.m0 = 1;  c.m1 = k * (p.A * p.A - 1);  c.m2 = 0;
+                break;
+
+            case FilterType::lowShelf:
+                g /= p.sqrtA;
+                c.m0 = 1;  c.m1 = k * (p.A - 1);  c.m2 = p.A * p.A - 1;
+                break;
+
+            case FilterType::highShelf:
+                g *= p.sqrtA;
+                c.m0 = p.A * p.A;  c.m1 = k * (1 - p.A) * p.A;  c.m2 = 1 - p.A * p.A;
+                break;
+        }
+
+        c.k  = k;
+        c.a1 = (SampleType) 1 / ((SampleType) 1 + g * (g + k));
+        c.a2 = g * c.a1;
+        c.a3 = g * c.a2;
+        return c;
+    }
+
+    static SvfCoefficients design (const BandSettings& band, double sampleRate) noexcept
+    {
+        return design (Prototype::make (band.type, band.gainDb, sampleRate),
+                       (SampleType) band.frequency, (SampleType) band.q);
+    }
+};
+
+//==============================================================================
+/** The two integrator states of a TPT SVF. */
+template <typename SampleType>
+struct SvfState
+{
+    SampleType ic1 = 0, ic2 = 0;
+
+    SampleType processSample (const SvfCoefficients<SampleType>& c, SampleType x) noexcept
+    {
+        const auto v3 = x - ic2;
+        const auto v1 = c.a1 * ic1 + c.a2 * v3;
+        const auto v2 = ic2 + c.a2 * ic1 + c.a3 * v3;
+        ic1 = 2 * v1 - ic1;
+        ic2 = 2 * v2 - ic2;
+        return c.m0 * x + c.m1 * v1 + c.m2 * v2;
+    }
+
+    void reset() noexcept  { ic1 = ic2 = 0; }
+};
+
+} // namespace iir
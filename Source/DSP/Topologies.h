@@ -0,0 +1,211 @@
+#pragma once
+
+#include "BiquadCoefficients.h"
+#include "StateVariableFilter.h"
+
+namespace iir
+{
+
+//==============================================================================
+/** The lattice-ladder form of a biquad, with normalised (rotation) stages.
+
+    Each stage is a plane rotation by the reflection coefficient k, so the
+    internal signals stay bounded by the input energy whatever the pole radius.
+    The ladder taps v pick the numerator off the backward signals.
+*/
+template <typename SampleType>
+struct LatticeCoefficients
+{
+    SampleType k1 = 0, c1 = 1, k2 = 0, c2 = 1;
+    SampleType v0 = 1, v1 = 0, v2 = 0;
+
+    static LatticeCoefficients fromBiquad (const BiquadCoefficients<double>& b) noexcept
+    {
+        // Reflection coefficients of 1 + a1 z^-1 + a2 z^-2
+        const auto k2 = b.a2;
+        const auto k1 = b.a1 / (1.0 + b.a2);
+        const auto c2 = std::sqrt (juce::jmax (0.0, 1.0 - k2 * k2));
+        const auto c1 = std::sqrt (juce::jmax (0.0, 1.0 - k1 * k1));
+
+        // Taps of the unnormalised ladder, then scaled by each stage's gain
+        const auto v2 = b.b2;
+        const auto v1 = b.b1 - v2 * b.a1;
+        const auto v0 = b.b0 - v1 * k1 - v2 * b.a2;
+
+        LatticeCoefficients l;
+        l.k1 = (SampleType) k1;  l.c1 = (SampleType) c1;
+        l.k2 = (SampleType) k2;  l.c2 = (SampleType) c2;
+        l.v2 = (SampleType) v2;
+        l.v1 = (SampleType) (c2 > 0.0 ? v1 / c2 : 0.0);
+        l.v0 = (SampleType) (c1 * c2 > 0.0 ? v0 / (c1 * c2) : 0.0);
+        return l;
+    }
+};
+
+//==============================================================================
+/** A second-order state-space realisation:
+        s[n+1] = A s[n] + B x[n],   y[n] = C s[n] + D x[n]
+
+    For complex poles r e^{+-jw}, A is the rotation [[re, -im], [im, re]], i.e.
+    the Gold-Rader coupled form, whose pole grid is uniform near z = 1 and so
+    keeps its accuracy at low cutoffs. Real poles use a diagonal (or Jordan) A.
+*/
+template <typename SampleType>
+struct StateSpaceCoefficients
+{
+    SampleType a11 = 0, a12 = 0, a21 = 0, a22 = 0;
+    SampleType b1 = 0, b2 = 0;
+    SampleType c1 = 0, c2 = 0;
+    SampleType d = 1;
+
+    static StateSpaceCoefficients fromBiquad (const BiquadCoefficients<double>& b) noexcept
+    {
+        // H(z) = b0 + (beta1 z + beta2) / (z^2 + a1 z + a2)
+        const auto beta1 = b.b1 - b.b0 * b.a1;
+        const auto beta2 = b.b2 - b.b0 * b.a2;
+        const auto disc = b.a1 * b.a1 * 0.25 - b.a2;
+
+        double a11, a12, a21, a22, b1, b2, c1, c2;
+
+        if (disc < 0.0)
+        {
+            const auto re = -b.a1 * 0.5;
+            const auto im = std::sqrt (-disc);
+
+            a11 = re;  a12 = -im;
+            a21 = im;  a22 = re;
+            b1 = 1.0;  b2 = 0.0;
+            c1 = beta1;
+            c2 = (beta2 + beta1 * re) / im;
+        }
+        else if (disc > 1.0e-12)
+        {
+            const auto p1 = -b.a1 * 0.5 + std::sqrt (disc);
+            const auto p2 = -b.a1 * 0.5 - std::sqrt (disc);
+
+            a11 = p1;   a12 = 0.0;
+            a21 = 0.0;  a22 = p2;
+            b1 = 1.0;   b2 = 1.0;
+            c1 = (beta1 * p1 + beta2) / (p1 - p2);
+            c2 = beta1 - c1;
+        }
+        else
+        {
+            const auto p = -b.a1 * 0.5;
+
+            a11 = p;    a12 = 0.0;
+            a21 = 1.0;  a22 = p;
+            b1 = 1.0;   b2 = 0.0;
+            c1 = beta1;
+            c2 = beta2 + beta1 * p;
+        }
+
+        StateSpaceCoefficients s;
+        s.a11 = (SampleType) a11;  s.a12 = (SampleType) a12;
+        s.a21 = (SampleType) a21;  s.a22 = (SampleType) a22;
+        s.b1 = (SampleType) b1;    s.b2 = (SampleType) b2;
+        s.c1 = (SampleType) c1;    s.c2 = (SampleType) c2;
+        s.d = (SampleType) b.b0;
+        return s;
+    }
+};
+
+//==============================================================================
+/** A float biquad that stays accurate for low, high-Q sections at high sample
+    rates, where a plain direct form loses 40-80 dB of SNR.
+
+    Three things are done differently:
+    - the direct feed-through is split off, H(z) = b0 + (e1 z^-1 + e2 z^-2) / A(z),
+      so the recursive part only sees the small residual numerator, which is
+      computed in double and so survives rounding to float;
+    - A(z) is stored as its distance from (1 - z^-1)^2, i.e. a1 = -2 + d1 and
+      a2 = 1 - d2, so the tiny d1 and d2 keep their full relative precision;
+    - the recursion is run as w[n] = w[n-1] + s[n], and s[n], the increment
+      before rounding, is carried to the next sample instead of the increment
+      that was actually applied. That is first-order error feedback on the
+      accumulator: whatever rounding lost this sample is added back on the next.
+
+    The carry is decayed as carry - d2 carry rather than by a stored 1 - d2,
+    which in float would keep only the top few bits of d2.
+*/
+template <typename SampleType>
+struct ErrorFeedbackCoefficients
+{
+    SampleType b0 = 1, e1 = 0, e2 = 0;
+    SampleType d2 = 0, feedback = 0;
+
+    static ErrorFeedbackCoefficients fromBiquad (const BiquadCoefficients<double>& b) noexcept
+    {
+        const auto d1 = b.a1 + 2.0;
+        const auto d2 = 1.0 - b.a2;
+
+        ErrorFeedbackCoefficients c;
+        c.b0 = (SampleType) b.b0;
+        c.e1 = (SampleType) (b.b1 - b.b0 * b.a1);
+        c.e2 = (SampleType) (b.b2 - b.b0 * b.a2);
+        c.d2        = (SampleType) d2;
+        c.feedback  = (SampleType) (d1 - d2);
+        return c;
+    }
+};
+
+//==============================================================================
+/** The coefficients of one band, in the form its topology needs. Only the
+    member matching the topology is meaningful.
+*/
+template <typename SampleType>
+struct SectionCoefficients
+{
+    Topology topology = Topology::transposedDirectForm2;
+    BiquadCoefficients<SampleType> biquad;
+    SvfCoefficients<SampleType> svf;
+    LatticeCoefficients<SampleType> lattice;
+    StateSpaceCoefficients<SampleType> stateSpace;
+    ErrorFeedbackCoefficients<SampleType> errorFeedback;
+
+    static SectionCoefficients design (const BandSettings& band, double sampleRate) noexcept
+    {
+        SectionCoefficients s;
+        s.topology = band.topology;
+
+        if (band.topology == Topology::stateVariable)
+        {
+            s.svf = SvfCoefficients<SampleType>::design (band, sampleRate);
+            return s;
+        }
+
+        return fromBiquad (BiquadCoefficients<double>::design (band, sampleRate), band.topology);
+    }
+
+    /** Maps a biquad designed in double onto the given topology. The state
+        variable filter is designed from the band settings instead, so asking
+        for it here gets transposed direct form II.
+    */
+    static SectionCoefficients fromBiquad (const BiquadCoefficients<double>& reference, Topology topology) noexcept
+    {
+        jassert (topology != Topology::stateVariable);
+
+        SectionCoefficients s;
+        s.topology = topology == Topology::stateVariable ? Topology::transposedDirectForm2 : topology;
+
+        switch (s.topology)
+        {
+            case Topology::directForm1:
+            case Topology::transposedDirectForm2:
+            case Topology::stateVariable:
+                s.biquad = { (SampleType) reference.b0, (SampleType) reference.b1, (SampleType) reference.b2,
+                             (SampleType) reference.a1, (SampleType) reference.a2 };
+                break;
+
+            case Topology::normalisedLattice:  s.lattice = LatticeCoefficients<SampleType>::fromBiquad (reference); break;
+            case Topology::coupledForm:        s.stateSpace = StateSpaceCoefficients<SampleType>::fromBiquad (reference); break;
+            case Topology::errorFeedback:      s.errorFeedback = ErrorFeedbackCoefficients<SampleType>::fromBiquad (reference); break;
+        }
+
+        return s;
+    }
+
+    static SectionCoefficients identity() noexcept  { return {}; }
+};
+
+} // namespace iir
@@ -0,0 +1,253 @@
+#include "WorkerPool.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+#if JUCE_LINUX
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#elif JUCE_MAC
+ #include <mach/mach.h>
+#elif JUCE_WINDOWS
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#endif
+
+namespace iir
+{
+
+/** Tells the core this thread is busy-waiting. */
+static void pause() noexcept
+{
+   #if JUCE_INTEL
+    _mm_pause();
+   #elif JUCE_ARM && (JUCE_GCC || JUCE_CLANG)
+    __asm__ __volatile__ ("yield");
+   #endif
+}
+
+//==============================================================================
+/** Wakes one sleeping thread from the audio thread.
+
+    juce::WaitableEvent signals under a mutex, which the audio thread could
+    find held by the thread it is waking. Here signal() is a single system
+    call that takes no lock in user space: a futex on Linux, a Mach semaphore
+    on macOS and a kernel semaphore on Windows. Other platforms fall back to
+    juce::WaitableEvent. A signal with nobody waiting lets the next wait()
+    return straight away; waits may also return early, so callers check why
+    they woke.
+*/
+class Wakeup
+{
+public:
+   #if JUCE_LINUX
+    Wakeup() = default;
+
+    void signal() noexcept
+    {
+        if (state.exchange (1) == 0)
+            futex (FUTEX_WAKE_PRIVATE, 1, nullptr);
+    }
+
+    void wait (int milliseconds) noexcept
+    {
+        if (state.exchange (0) == 1)
+            return;
+
+        const timespec timeout { milliseconds / 1000, (long) (milliseconds % 1000) * 1000000 };
+        futex (FUTEX_WAIT_PRIVATE, 0, &timeout);
+        state.store (0);
+    }
+
+   private:
+    static_assert (sizeof (std::atomic<int>) == sizeof (int) && std::atomic<int>::is_always_lock_free);
+
+    void futex (int op, int value, const timespec* timeout) noexcept
+    {
+        syscall (SYS_futex, reinterpret_cast<int*> (&state), op, value, timeout, nullptr, 0);
+    }
+
+    std::atomic<int> state { 0 };
+
+   #elif JUCE_MAC
+    Wakeup()   { semaphore_create (mach_task_self(), &semaphore, SYNC_POLICY_FIFO, 0); }
+    ~Wakeup()  { semaphore_destroy (mach_task_self(), semaphore); }
+
+    void signal() noexcept  { semaphore_signal (semaphore); }
+
+    void wait (int milliseconds) noexcept
+    {
+        semaphore_timedwait (semaphore, { (unsigned int) (milliseconds / 1000), (clock_res_t) (milliseconds % 1000) * 1000000 });
+    }
+
+   private:
+    semaphore_t semaphore {};
+
+   #elif JUCE_WINDOWS
+    Wakeup()   : semaphore (CreateSemaphoreW (nullptr, 0, 1, nullptr)) {}
+    ~Wakeup()  { CloseHandle (semaphore); }
+
+    // Fails harmlessly when a signal is already pending, as the count tops out at 1
+    void signal() noexcept  { ReleaseSemaphore (semaphore, 1, nullptr); }
+
+    void wait (int milliseconds) noexcept  { WaitForSingleObject (semaphore, (DWORD) milliseconds); }
+
+   private:
+    HANDLE semaphore;
+
+   #else
+    Wakeup() = default;
+
+    void signal() noexcept                  { event.signal(); }
+    void wait (int milliseconds) noexcept   { event.wait (milliseconds); }
+
+   private:
+    juce::WaitableEvent event;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (Wakeup)
+};
+
+//==============================================================================
+class WorkerPool::Worker final : private juce::Thread
+{
+public:
+    Worker (WorkerPool& owner, int participantIndex)
+        : juce::Thread ("IIRFilters worker " + juce::String (participantIndex)),
+          pool (owner),
+          participant (participantIndex)
+    {
+        if (! startRealtimeThread (juce::Thread::RealtimeOptions {}))
+            startThread (juce::Thread::Priority::highest);
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wake.signal();
+        stopThread (1000);
+    }
+
+    /** Audio thread: called after publishing a block. Clears the flag, so a
+        worker is signalled once per sleep however many blocks go by.
+    */
+    void wakeIfAsleep() noexcept
+    {
+        if (asleep.exchange (false))
+            wake.signal();
+    }
+
+private:
+    // Long enough to bridge the gap between the blocks of a busy host at
+    // small block sizes, short enough not to hog a core while it's idle
+    static constexpr double spinSeconds = 0.0002;
+
+    void run() override
+    {
+        auto lastBlock = getBlock (pool.ticket.load());
+
+        while (! threadShouldExit())
+        {
+            if (! waitForNextBlock (lastBlock))
+                continue;
+
+            lastBlock = getBlock (pool.ticket.load());
+            pool.work (participant);
+        }
+    }
+
+    bool waitForNextBlock (std::uint64_t lastBlock) noexcept
+    {
+        const auto spinEnd = juce::Time::getHighResolutionTicks()
+                           + (juce::int64) (spinSeconds * (double) juce::Time::getHighResolutionTicksPerSecond());
+
+        while (juce::Time::getHighResolutionTicks() < spinEnd)
+        {
+            if (getBlock (pool.ticket.load()) != lastBlock)
+                return true;
+
+            pause();
+        }
+
+        // Either run() sees the flag and signals, or this sees the new block:
+        // both sides store first and load second, sequentially consistent
+        asleep.store (true);
+
+        if (getBlock (pool.ticket.load()) == lastBlock)
+            wake.wait (100);
+
+        asleep.store (false);
+        return getBlock (pool.ticket.load()) != lastBlock;
+    }
+
+    WorkerPool& pool;
+    const int participant;
+    Wakeup wake;
+    std::atomic<bool> asleep { false };
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+WorkerPool::WorkerPool (int numWorkers)
+{
+    for (int i = 0; i < numWorkers; ++i)
+        workers.push_back (std::make_unique<Worker> (*this, i + 1));
+}
+
+WorkerPool::~WorkerPool()
+{
+    workers.clear();
+}
+
+void WorkerPool::run (Job& newJob, int numTasks) noexcept
+{
+    jassert (numTasks <= maxTasks);
+    numTasks = juce::jmin (numTasks, maxTasks);
+
+    if (workers.empty())
+    {
+        for (int task = 0; task < numTasks; ++task)
+            newJob.run (task, 0);
+
+        return;
+    }
+
+    job = &newJob;
+    numFinished.store (0, std::memory_order_relaxed);
+
+    const auto block = getBlock (ticket.load (std::memory_order_relaxed)) + 1;
+    ticket.store ((block << 32) | ((std::uint64_t) numTasks << 16));
+
+    for (auto& worker : workers)
+        worker->wakeIfAsleep();
+
+    work (0);
+
+    // Only tasks that have already started can be left, so this is short
+    while (numFinished.load (std::memory_order_acquire) < numTasks)
+        pause();
+}
+
+void WorkerPool::work (int participant) noexcept
+{
+    auto t = ticket.load (std::memory_order_acquire);
+
+    while (getNextTask (t) < getNumTasks (t))
+    {
+        // Fails, and reloads t, if another participant took the task or a
+        // new block has started since
+        if (ticket.compare_exchange_weak (t, t + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            job->run (getNextTask (t), participant);
+            numFinished.fetch_add (1, std::memory_order_release);
+            t = ticket.load (std::memory_order_acquire);
+        }
+    }
+}
+
+} // namespace iir
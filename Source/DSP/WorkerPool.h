@@ -0,0 +1,73 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace iir
+{
+
+//==============================================================================
+/** A few real-time worker threads that help the audio thread through one
+    block's worth of independent tasks.
+
+    run() publishes the tasks, works on them itself alongside the workers and
+    returns once every task has finished, so nothing runs past the end of
+    processBlock(). Tasks are handed out one at a time from a shared counter:
+    a worker that wakes late, or not at all, only means the audio thread does
+    more of the work itself, never that it waits for a task nobody started.
+
+    Between blocks the workers spin for a while on the block counter, then
+    go to sleep on a semaphore that run() only signals for workers that are
+    actually asleep. Signalling takes no lock in user space: a futex on
+    Linux, a Mach semaphore on macOS, a kernel semaphore on Windows. run()
+    itself never blocks and never allocates.
+*/
+class WorkerPool
+{
+public:
+    /** The work for one block, split into tasks that can run in any order
+        and on any thread. participant is 0 for the audio thread and 1 to
+        getNumWorkers() for the workers, so each can use its own scratch.
+    */
+    struct Job
+    {
+        virtual ~Job() = default;
+        virtual void run (int task, int participant) noexcept = 0;
+    };
+
+    /** Starts the workers at real-time priority. Not real-time safe. */
+    explicit WorkerPool (int numWorkers);
+
+    /** Stops and joins the workers. Not real-time safe. */
+    ~WorkerPool();
+
+    int getNumWorkers() const noexcept  { return (int) workers.size(); }
+
+    /** Runs tasks 0 to numTasks - 1 of the job on the calling thread and the
+        workers, and returns when they have all finished.
+    */
+    void run (Job& job, int numTasks) noexcept;
+
+    static constexpr int maxTasks = 0xffff;
+
+private:
+    //==============================================================================
+    class Worker;
+
+    // The ticket packs the block number, the number of tasks and the next task
+    // to hand out, so a worker can never take a task of a block that has
+    // already moved on
+    static constexpr std::uint64_t getBlock (std::uint64_t ticket) noexcept     { return ticket >> 32; }
+    static constexpr int getNumTasks (std::uint64_t ticket) noexcept            { return (int) ((ticket >> 16) & 0xffff); }
+    static constexpr int getNextTask (std::uint64_t ticket) noexcept            { return (int) (ticket & 0xffff); }
+
+    void work (int participant) noexcept;
+
+    std::atomic<std::uint64_t> ticket { 0 };
+    std::atomic<int> numFinished { 0 };
+    Job* job = nullptr;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorkerPool)
+};
+
+} // namespace iir
@@ -0,0 +1,614 @@
+#include "Parameters.h"
+
+namespace Parameters
+{
+
+//==============================================================================
+const char* getFieldName (BandField field) noexcept
+{
+    switch (field)
+    {
+        case BandField::enabled:    return "enabled";
+        case BandField::type:       return "type";
+        case BandField::frequency:  return "frequency";
+        case BandField::q:          return "q";
+        case BandField::gain:       return "gain";
+        case BandField::topology:   return "topology";
+        case BandField::placement:  return "placement";
+    }
+
+    jassertfalse;
+    return "";
+}
+
+const char* getFieldName (ModulationField field) noexcept
+{
+    switch (field)
+    {
+        case ModulationField::enabled:           return "enabled";
+        case ModulationField::type:              return "type";
+        case ModulationField::frequency:         return "frequency";
+        case ModulationField::q:                 return "q";
+        case ModulationField::gain:              return "gain";
+        case ModulationField::lfoRate:           return "lfoRate";
+        case ModulationField::lfoToCutoff:       return "lfoToCutoff";
+        case ModulationField::lfoToQ:            return "lfoToQ";
+        case ModulationField::envelopeAttack:    return "envelopeAttack";
+        case ModulationField::envelopeRelease:   return "envelopeRelease";
+        case ModulationField::envelopeToCutoff:  return "envelopeToCutoff";
+        case ModulationField::envelopeToQ:       return "envelopeToQ";
+    }
+
+    jassertfalse;
+    return "";
+}
+
+const char* getFieldName (CutField field) noexcept
+{
+    switch (field)
+    {
+        case CutField::enabled:      return "enabled";
+        case CutField::family:       return "family";
+        case CutField::order:        return "order";
+        case CutField::frequency:    return "frequency";
+        case CutField::ripple:       return "ripple";
+        case CutField::attenuation:  return "attenuation";
+    }
+
+    jassertfalse;
+    return "";
+}
+
+const char* getFieldName (DynamicsField field) noexcept
+{
+    switch (field)
+    {
+        case DynamicsField::enabled:    return "enabled";
+        case DynamicsField::sidechain:  return "sidechain";
+        case DynamicsField::threshold:  return "threshold";
+        case DynamicsField::ratio:      return "ratio";
+        case DynamicsField::attack:     return "attack";
+        case DynamicsField::release:    return "release";
+        case DynamicsField::range:      return "range";
+    }
+
+    jassertfalse;
+    return "";
+}
+
+const char* getFieldName (HumField field) noexcept
+{
+    switch (field)
+    {
+        case HumField::enabled:    return "enabled";
+        case HumField::mains:      return "mains";
+        case HumField::harmonics:  return "harmonics";
+        case HumField::width:      return "width";
+        case HumField::track:      return "track";
+    }
+
+    jassertfalse;
+    return "";
+}
+
+const char* getFieldName (ResonatorField field) noexcept
+{
+    switch (field)
+    {
+        case ResonatorField::enabled:  return "enabled";
+        case ResonatorField::mix:      return "mix";
+    }
+
+    jassertfalse;
+    return "";
+}
+
+const char* getFieldName (CrossoverField field) noexcept
+{
+    switch (field)
+    {
+        case CrossoverField::enabled:     return "enabled";
+        case CrossoverField::bands:       return "bands";
+        case CrossoverField::slope:       return "slope";
+        case CrossoverField::frequency1:  return "frequency1";
+        case CrossoverField::frequency2:  return "frequency2";
+        case CrossoverField::frequency3:  return "frequency3";
+        case CrossoverField::frequency4:  return "frequency4";
+        case CrossoverField::frequency5:  return "frequency5";
+        case CrossoverField::frequency6:  return "frequency6";
+        case CrossoverField::frequency7:  return "frequency7";
+    }
+
+    jassertfalse;
+    return "";
+}
+
+const char* getFieldName (GlobalField field) noexcept
+{
+    switch (field)
+    {
+        case GlobalField::midSide:     return "midSide";
+        case GlobalField::warmBypass:  return "warmBypass";
+    }
+
+    jassertfalse;
+    return "";
+}
+
+juce::String getPath (int index)
+{
+    jassert (juce::isPositiveAndBelow (index, numParameters));
+
+    if (isBandParameter (index))
+        return "band/" + juce::String (getBand (index) + 1) + "/" + getFieldName (getBandField (index));
+
+    if (isModulationParameter (index))
+        return juce::String ("modulation/") + getFieldName (getModulationField (index));
+
+    if (isCutParameter (index))
+        return juce::String (getCutSlot (index) == iir::lowCut ? "lowCut/" : "highCut/") + getFieldName (getCutField (index));
+
+    if (isDynamicsParameter (index))
+        return "band/" + juce::String (getDynamicsBand (index) + 1) + "/dynamics/" + getFieldName (getDynamicsField (index));
+
+    if (isHumParameter (index))
+        return juce::String ("hum/") + getFieldName (getHumField (index));
+
+    if (isResonatorParameter (index))
+        return juce::String ("resonator/") + getFieldName (getResonatorField (index));
+
+    if (isCrossoverParameter (index))
+        return juce::String ("crossover/") + getFieldName (getCrossoverField (index));
+
+    return juce::String ("global/") + getFieldName (getGlobalField (index));
+}
+
+juce::String getId (int index)
+{
+    return getPath (index).replaceCharacter ('/', '_');
+}
+
+int getVersionHint (int index) noexcept
+{
+    jassert (juce::isPositiveAndBelow (index, numParameters));
+
+    if (isHumParameter (index))
+        return 3;
+
+    if (isResonatorParameter (index))
+        return 4;
+
+    if (isCrossoverParameter (index))
+        return 5;
+
+    if (index == indexOf (GlobalField::warmBypass))
+        return 2;
+
+    // Bands, modulation, cuts, dynamics and mid/side were all there when the
+    // parameters were first exposed
+    return 1;
+}
+
+juce::String getName (int index)
+{
+    jassert (juce::isPositiveAndBelow (index, numParameters));
+
+    if (isBandParameter (index))
+        return "Band " + juce::String (getBand (index) + 1) + " " + getFieldName (getBandField (index));
+
+    if (isModulationParameter (index))
+        return juce::String ("Mod ") + getFieldName (getModulationField (index));
+
+    if (isCutParameter (index))
+        return juce::String (getCutSlot (index) == iir::lowCut ? "Low cut " : "High cut ") + getFieldName (getCutField (index));
+
+    if (isDynamicsParameter (index))
+        return "Band " + juce::String (getDynamicsBand (index) + 1) + " dyn " + getFieldName (getDynamicsField (index));
+
+    if (isHumParameter (index))
+        return juce::String ("Hum ") + getFieldName (getHumField (index));
+
+    if (isResonatorParameter (index))
+        return juce::String ("Resonator ") + getFieldName (getResonatorField (index));
+
+    if (isCrossoverParameter (index))
+        return juce::String ("Crossover ") + getFieldName (getCrossoverField (index));
+
+    return getFieldName (getGlobalField (index));
+}
+
+bool isToggle (int index) noexcept
+{
+    if (isBandParameter (index))
+        return getBandField (index) == BandField::enabled;
+
+    if (isModulationParameter (index))
+        return getModulationField (index) == ModulationField::enabled;
+
+    if (isCutParameter (index))
+        return getCutField (index) == CutField::enabled;
+
+    if (isDynamicsParameter (index))
+        return getDynamicsField (index) == DynamicsField::enabled
+            || getDynamicsField (index) == DynamicsField::sidechain;
+
+    if (isHumParameter (index))
+        return getHumField (index) == HumField::enabled
+            || getHumField (index) == HumField::track;
+
+    if (isResonatorParameter (index))
+        return getResonatorField (index) == ResonatorField::enabled;
+
+    if (isCrossoverParameter (index))
+        return getCrossoverField (index) == CrossoverField::enabled;
+
+    return true;
+}
+
+juce::StringArray getChoices (int index)
+{
+    static const juce::StringArray filterTypes { "Low pass", "High pass", "Band pass", "Notch", "Peak", "Low shelf", "High shelf" };
+    static const juce::StringArray topologies { "Direct form I", "Transposed DF II", "State variable", "Lattice", "Coupled form", "Error feedback" };
+    static const juce::StringArray placements { "Stereo", "Mid", "Side" };
+    static const juce::StringArray families { "Butterworth", "Chebyshev", "Elliptic" };
+    static const juce::StringArray mains { "50 Hz", "60 Hz" };
+    static const juce::StringArray slopes { "LR4 (24 dB/oct)", "LR8 (48 dB/oct)" };
+
+    if (isBandParameter (index))
+    {
+        switch (getBandField (index))
+        {
+            case BandField::type:       return filterTypes;
+            case BandField::topology:   return topologies;
+            case BandField::placement:  return placements;
+            default:                    return {};
+        }
+    }
+
+    if (isModulationParameter (index))
+        return getModulationField (index) == ModulationField::type ? filterTypes : juce::StringArray();
+
+    if (isCutParameter (index))
+        return getCutField (index) == CutField::family ? families : juce::StringArray();
+
+    if (isHumParameter (index))
+        return getHumField (index) == HumField::mains ? mains : juce::StringArray();
+
+    if (isCrossoverParameter (index))
+        return getCrossoverField (index) == CrossoverField::slope ? slopes : juce::StringArray();
+
+    return {};
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout createLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    for (int index = 0; index < numParameters; ++index)
+    {
+        const auto id = juce::ParameterID { getId (index), getVersionHint (index) };
+        const auto name = getName (index);
+        const auto range = getRange (index);
+        const auto choices = getChoices (index);
+
+        if (isToggle (index))
+        {
+            layout.add (std::make_unique<juce::AudioParameterBool> (id, name, range.defaultValue >= 0.5f));
+        }
+        else if (! choices.isEmpty())
+        {
+            jassert (choices.size() == juce::roundToInt (range.maximum) + 1);
+            layout.add (std::make_unique<juce::AudioParameterChoice> (id, name, choices, juce::roundToInt (range.defaultValue)));
+        }
+        else if ((isCutParameter (index) && getCutField (index) == CutField::order)
+                 || (isHumParameter (index) && getHumField (index) == HumField::harmonics)
+                 || (isCrossoverParameter (index) && getCrossoverField (index) == CrossoverField::bands))
+        {
+            layout.add (std::make_unique<juce::AudioParameterInt> (id, name, juce::roundToInt (range.minimum),
+                                                                   juce::roundToInt (range.maximum),
+                                                                   juce::roundToInt (range.defaultValue)));
+        }
+        else
+        {
+            juce::NormalisableRange<float> normalisable { range.minimum, range.maximum };
+
+            // Frequencies, times and Qs spanning decades get the middle of the
+            // control at their geometric centre
+            if (range.minimum > 0.0f && range.maximum >= 100.0f * range.minimum)
+                normalisable.setSkewForCentre (std::sqrt (range.minimum * range.maximum));
+
+            layout.add (std::make_unique<juce::AudioParameterFloat> (id, name, normalisable, range.defaultValue));
+        }
+    }
+
+    return layout;
+}
+
+//==============================================================================
+static Range getBandRange (BandField field) noexcept
+{
+    switch (field)
+    {
+        case BandField::enabled:    return { 0.0f, 1.0f, 0.0f };
+        case BandField::type:       return { 0.0f, (float) (iir::numFilterTypes - 1), (float) iir::FilterType::peak };
+        case BandField::frequency:  return { 20.0f, 20000.0f, 1000.0f };
+        case BandField::q:          return { 0.1f, 40.0f, 0.70710678f };
+        case BandField::gain:       return { -24.0f, 24.0f, 0.0f };
+        case BandField::topology:   return { 0.0f, (float) (iir::numTopologies - 1), (float) iir::Topology::transposedDirectForm2 };
+        case BandField::placement:  return { 0.0f, (float) (iir::numPlacements - 1), (float) iir::Placement::stereo };
+    }
+
+    jassertfalse;
+    return { 0.0f, 1.0f, 0.0f };
+}
+
+static Range getModulationRange (ModulationField field) noexcept
+{
+    switch (field)
+    {
+        case ModulationField::enabled:           return { 0.0f, 1.0f, 0.0f };
+        case ModulationField::type:              return { 0.0f, (float) (iir::numFilterTypes - 1), (float) iir::FilterType::lowPass };
+        case ModulationField::frequency:         return { 20.0f, 20000.0f, 1000.0f };
+        case ModulationField::q:                 return { 0.1f, 40.0f, 0.70710678f };
+        case ModulationField::gain:              return { -24.0f, 24.0f, 0.0f };
+        case ModulationField::lfoRate:           return { 0.01f, 100.0f, 1.0f };
+        case ModulationField::lfoToCutoff:       return { -8.0f, 8.0f, 0.0f };
+        case ModulationField::lfoToQ:            return { -4.0f, 4.0f, 0.0f };
+        case ModulationField::envelopeAttack:    return { 0.1f, 500.0f, 5.0f };
+        case ModulationField::envelopeRelease:   return { 1.0f, 5000.0f, 100.0f };
+        case ModulationField::envelopeToCutoff:  return { -8.0f, 8.0f, 0.0f };
+        case ModulationField::envelopeToQ:       return { -4.0f, 4.0f, 0.0f };
+    }
+
+    jassertfalse;
+    return { 0.0f, 1.0f, 0.0f };
+}
+
+static Range getCutRange (iir::CutSlot slot, CutField field) noexcept
+{
+    switch (field)
+    {
+        case CutField::enabled:      return { 0.0f, 1.0f, 0.0f };
+        case CutField::family:       return { 0.0f, (float) (iir::numPrototypeFamilies - 1), (float) iir::PrototypeFamily::butterworth };
+        case CutField::order:        return { 1.0f, (float) iir::maxCutOrder, 4.0f };
+        case CutField::frequency:    return { 20.0f, 20000.0f, slot == iir::lowCut ? 30.0f : 18000.0f };
+        case CutField::ripple:       return { 0.01f, 3.0f, 0.5f };
+        case CutField::attenuation:  return { 20.0f, 120.0f, 60.0f };
+    }
+
+    jassertfalse;
+    return { 0.0f, 1.0f, 0.0f };
+}
+
+static Range getDynamicsRange (DynamicsField field) noexcept
+{
+    switch (field)
+    {
+        case DynamicsField::enabled:    return { 0.0f, 1.0f, 0.0f };
+        case DynamicsField::sidechain:  return { 0.0f, 1.0f, 0.0f };
+        case DynamicsField::threshold:  return { -60.0f, 0.0f, -24.0f };
+        case DynamicsField::ratio:      return { 1.0f, 20.0f, 4.0f };
+        case DynamicsField::attack:     return { 0.1f, 200.0f, 5.0f };
+        case DynamicsField::release:    return { 1.0f, 2000.0f, 80.0f };
+        case DynamicsField::range:      return { 0.0f, 24.0f, 12.0f };
+    }
+
+    jassertfalse;
+    return { 0.0f, 1.0f, 0.0f };
+}
+
+static Range getHumRange (HumField field) noexcept
+{
+    switch (field)
+    {
+        case HumField::enabled:    return { 0.0f, 1.0f, 0.0f };
+        case HumField::mains:      return { 0.0f, (float) (iir::numMainsFrequencies - 1), (float) iir::MainsFrequency::hz50 };
+        case HumField::harmonics:  return { 1.0f, (float) iir::maxHumHarmonics, 4.0f };
+        case HumField::width:      return { 0.5f, 10.0f, 2.0f };
+        case HumField::track:      return { 0.0f, 1.0f, 1.0f };
+    }
+
+    jassertfalse;
+    return { 0.0f, 1.0f, 0.0f };
+}
+
+static Range getResonatorRange (ResonatorField field) noexcept
+{
+    switch (field)
+    {
+        case ResonatorField::enabled:  return { 0.0f, 1.0f, 0.0f };
+        case ResonatorField::mix:      return { 0.0f, 1.0f, 0.5f };
+    }
+
+    jassertfalse;
+    return { 0.0f, 1.0f, 0.0f };
+}
+
+static Range getCrossoverRange (CrossoverField field) noexcept
+{
+    static_assert (numCrossoverFields == (int) CrossoverField::frequency1 + iir::maxCrossoverBands - 1,
+                   "One frequency per split");
+
+    switch (field)
+    {
+        case CrossoverField::enabled:  return { 0.0f, 1.0f, 0.0f };
+        case CrossoverField::bands:    return { 2.0f, (float) iir::maxCrossoverBands, 3.0f };
+        case CrossoverField::slope:    return { 0.0f, (float) (iir::numCrossoverSlopes - 1), (float) iir::CrossoverSlope::lr4 };
+        default:                       break;
+    }
+
+    const auto split = (size_t) field - (size_t) CrossoverField::frequency1;
+    return { 20.0f, 20000.0f, iir::CrossoverSettings().frequencies[split] };
+}
+
+static Range getGlobalRange (GlobalField field) noexcept
+{
+    switch (field)
+    {
+        case GlobalField::midSide:     return { 0.0f, 1.0f, 0.0f };
+        case GlobalField::warmBypass:  return { 0.0f, 1.0f, 0.0f };
+    }
+
+    jassertfalse;
+    return { 0.0f, 1.0f, 0.0f };
+}
+
+Range getRange (int index) noexcept
+{
+    jassert (juce::isPositiveAndBelow (index, numParameters));
+
+    if (isBandParameter (index))
+        return getBandRange (getBandField (index));
+
+    if (isModulationParameter (index))
+        return getModulationRange (getModulationField (index));
+
+    if (isCutParameter (index))
+        return getCutRange (getCutSlot (index), getCutField (index));
+
+    if (isDynamicsParameter (index))
+        return getDynamicsRange (getDynamicsField (index));
+
+    if (isHumParameter (index))
+        return getHumRange (getHumField (index));
+
+    if (isResonatorParameter (index))
+        return getResonatorRange (getResonatorField (index));
+
+    if (isCrossoverParameter (index))
+        return getCrossoverRange (getCrossoverField (index));
+
+    return getGlobalRange (getGlobalField (index));
+}
+
+//==============================================================================
+static void applyToBand (iir::BandSettings& band, BandField field, float value) noexcept
+{
+    switch (field)
+    {
+        case BandField::enabled:    band.enabled   = value >= 0.5f;                              break;
+        case BandField::type:       band.type      = (iir::FilterType) juce::roundToInt (value); break;
+        case BandField::frequency:  band.frequency = value;                                      break;
+        case BandField::q:          band.q         = value;                                      break;
+        case BandField::gain:       band.gainDb    = value;                                      break;
+        case BandField::topology:   band.topology  = (iir::Topology) juce::roundToInt (value);   break;
+        case BandField::placement:  band.placement = (iir::Placement) juce::roundToInt (value);  break;
+    }
+}
+
+static void applyToModulation (iir::ModulationSettings& mod, ModulationField field, float value) noexcept
+{
+    switch (field)
+    {
+        case ModulationField::enabled:           mod.enabled           = value >= 0.5f;                              break;
+        case ModulationField::type:              mod.type              = (iir::FilterType) juce::roundToInt (value); break;
+        case ModulationField::frequency:         mod.frequency         = value;                                      break;
+        case ModulationField::q:                 mod.q                 = value;                                      break;
+        case ModulationField::gain:              mod.gainDb            = value;                                      break;
+        case ModulationField::lfoRate:           mod.lfoRateHz         = value;                                      break;
+        case ModulationField::lfoToCutoff:       mod.lfoToCutoff       = value;                                      break;
+        case ModulationField::lfoToQ:            mod.lfoToQ            = value;                                      break;
+        case ModulationField::envelopeAttack:    mod.envelopeAttackMs  = value;                                      break;
+        case ModulationField::envelopeRelease:   mod.envelopeReleaseMs = value;                                      break;
+        case ModulationField::envelopeToCutoff:  mod.envelopeToCutoff  = value;                                      break;
+        case ModulationField::envelopeToQ:       mod.envelopeToQ       = value;                                      break;
+    }
+}
+
+static void applyToCut (iir::CutSettings& cut, CutField field, float value) noexcept
+{
+    switch (field)
+    {
+        case CutField::enabled:      cut.enabled       = value >= 0.5f;                                    break;
+        case CutField::family:       cut.family        = (iir::PrototypeFamily) juce::roundToInt (value);  break;
+        case CutField::order:        cut.order         = juce::roundToInt (value);                         break;
+        case CutField::frequency:    cut.frequency     = value;                                            break;
+        case CutField::ripple:       cut.rippleDb      = value;                                            break;
+        case CutField::attenuation:  cut.attenuationDb = value;                                            break;
+    }
+}
+
+static void applyToDynamics (iir::DynamicsSettings& dynamics, DynamicsField field, float value) noexcept
+{
+    switch (field)
+    {
+        case DynamicsField::enabled:    dynamics.enabled     = value >= 0.5f; break;
+        case DynamicsField::sidechain:  dynamics.sidechain   = value >= 0.5f; break;
+        case DynamicsField::threshold:  dynamics.thresholdDb = value;         break;
+        case DynamicsField::ratio:      dynamics.ratio       = value;         break;
+        case DynamicsField::attack:     dynamics.attackMs    = value;         break;
+        case DynamicsField::release:    dynamics.releaseMs   = value;         break;
+        case DynamicsField::range:      dynamics.rangeDb     = value;         break;
+    }
+}
+
+static void applyToHum (iir::HumSettings& hum, HumField field, float value) noexcept
+{
+    switch (field)
+    {
+        case HumField::enabled:    hum.enabled      = value >= 0.5f;                                   break;
+        case HumField::mains:      hum.mains        = (iir::MainsFrequency) juce::roundToInt (value);  break;
+        case HumField::harmonics:  hum.numHarmonics = juce::roundToInt (value);                        break;
+        case HumField::width:      hum.widthHz      = value;                                           break;
+        case HumField::track:      hum.track        = value >= 0.5f;                                   break;
+    }
+}
+
+static void applyToResonator (iir::ResonatorSettings& resonator, ResonatorField field, float value) noexcept
+{
+    switch (field)
+    {
+        case ResonatorField::enabled:  resonator.enabled = value >= 0.5f; break;
+        case ResonatorField::mix:      resonator.mix     = value;         break;
+    }
+}
+
+static void applyToCrossover (iir::CrossoverSettings& crossover, CrossoverField field, float value) noexcept
+{
+    switch (field)
+    {
+        case CrossoverField::enabled:  crossover.enabled  = value >= 0.5f;                                  break;
+        case CrossoverField::bands:    crossover.numBands = juce::roundToInt (value);                       break;
+        case CrossoverField::slope:    crossover.slope    = (iir::CrossoverSlope) juce::roundToInt (value); break;
+        default:
+            crossover.frequencies[(size_t) field - (size_t) CrossoverField::frequency1] = value;
+            break;
+    }
+}
+
+static void applyToGlobal (iir::FilterSettings& settings, GlobalField field, float value) noexcept
+{
+    switch (field)
+    {
+        case GlobalField::midSide:     settings.midSide    = value >= 0.5f; break;
+        case GlobalField::warmBypass:  settings.warmBypass = value >= 0.5f; break;
+    }
+}
+
+void apply (iir::FilterSettings& settings, int index, float value) noexcept
+{
+    if (! std::isfinite (value))
+        return;
+
+    const auto range = getRange (index);
+    value = juce::jlimit (range.minimum, range.maximum, value);
+
+    if (isBandParameter (index))
+        applyToBand (settings.bands[(size_t) getBand (index)], getBandField (index), value);
+    else if (isModulationParameter (index))
+        applyToModulation (settings.modulation, getModulationField (index), value);
+    else if (isCutParameter (index))
+        applyToCut (settings.cuts[(size_t) getCutSlot (index)], getCutField (index), value);
+    else if (isDynamicsParameter (index))
+        applyToDynamics (settings.dynamics[(size_t) getDynamicsBand (index)], getDynamicsField (index), value);
+    else if (isHumParameter (index))
+        applyToHum (settings.hum, getHumField (index), value);
+    else if (isResonatorParameter (index))
+        applyToResonator (settings.resonator, getResonatorField (index), value);
+    else if (isCrossoverParameter (index))
+        applyToCrossover (settings.crossover, getCrossoverField (index), value);
+    else
+        applyToGlobal (settings, getGlobalField (index), value);
+}
+
+} // namespace Parameters
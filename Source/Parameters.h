@@ -0,0 +1,248 @@
+#pragma once
+
+#include "DSP/FilterSettings.h"
+
+//==============================================================================
+/** The flat list of remotely controllable parameters.
+
+    The band parameters come first, band * numBandFields + field, followed by
+    the fields of the modulated band, those of the low and high cut, the
+    dynamics of each band, the hum removal, the resonator bank, the crossover
+    and finally the global switches.
+    The index is what travels through the ParameterQueue to the audio thread,
+    and createLayout() turns the same list into the host's parameters.
+*/
+namespace Parameters
+{
+    enum class BandField
+    {
+        enabled,
+        type,
+        frequency,
+        q,
+        gain,
+        topology,
+        placement
+    };
+
+    enum class ModulationField
+    {
+        enabled,
+        type,
+        frequency,
+        q,
+        gain,
+        lfoRate,
+        lfoToCutoff,
+        lfoToQ,
+        envelopeAttack,
+        envelopeRelease,
+        envelopeToCutoff,
+        envelopeToQ
+    };
+
+    enum class CutField
+    {
+        enabled,
+        family,
+        order,
+        frequency,
+        ripple,
+        attenuation
+    };
+
+    enum class DynamicsField
+    {
+        enabled,
+        sidechain,
+        threshold,
+        ratio,
+        attack,
+        release,
+        range
+    };
+
+    enum class HumField
+    {
+        enabled,
+        mains,
+        harmonics,
+        width,
+        track
+    };
+
+    enum class ResonatorField
+    {
+        enabled,
+        mix
+    };
+
+    enum class CrossoverField
+    {
+        enabled,
+        bands,
+        slope,
+        frequency1,
+        frequency2,
+        frequency3,
+        frequency4,
+        frequency5,
+        frequency6,
+        frequency7
+    };
+
+    enum class GlobalField
+    {
+        midSide,
+        warmBypass
+    };
+
+    constexpr int numBandFields = 7;
+    constexpr int numModulationFields = 12;
+    constexpr int numCutFields = 6;
+    constexpr int numDynamicsFields = 7;
+    constexpr int numHumFields = 5;
+    constexpr int numResonatorFields = 2;
+    constexpr int numCrossoverFields = 10;
+    constexpr int numGlobalFields = 2;
+    constexpr int firstModulationIndex = iir::maxBands * numBandFields;
+    constexpr int firstCutIndex = firstModulationIndex + numModulationFields;
+    constexpr int firstDynamicsIndex = firstCutIndex + iir::numCutSlots * numCutFields;
+    constexpr int firstHumIndex = firstDynamicsIndex + iir::maxBands * numDynamicsFields;
+    constexpr int firstResonatorIndex = firstHumIndex + numHumFields;
+    constexpr int firstCrossoverIndex = firstResonatorIndex + numResonatorFields;
+    constexpr int firstGlobalIndex = firstCrossoverIndex + numCrossoverFields;
+    constexpr int numParameters = firstGlobalIndex + numGlobalFields;
+
+    struct Range
+    {
+        float minimum, maximum, defaultValue;
+    };
+
+    constexpr int indexOf (int band, BandField field) noexcept
+    {
+        return band * numBandFields + (int) field;
+    }
+
+    constexpr int indexOf (ModulationField field) noexcept
+    {
+        return firstModulationIndex + (int) field;
+    }
+
+    constexpr int indexOf (iir::CutSlot slot, CutField field) noexcept
+    {
+        return firstCutIndex + (int) slot * numCutFields + (int) field;
+    }
+
+    constexpr int indexOf (int band, DynamicsField field) noexcept
+    {
+        return firstDynamicsIndex + band * numDynamicsFields + (int) field;
+    }
+
+    constexpr int indexOf (HumField field) noexcept
+    {
+        return firstHumIndex + (int) field;
+    }
+
+    constexpr int indexOf (ResonatorField field) noexcept
+    {
+        return firstResonatorIndex + (int) field;
+    }
+
+    constexpr int indexOf (CrossoverField field) noexcept
+    {
+        return firstCrossoverIndex + (int) field;
+    }
+
+    constexpr int indexOf (GlobalField field) noexcept
+    {
+        return firstGlobalIndex + (int) field;
+    }
+
+    constexpr bool isBandParameter (int index) noexcept       { return index < firstModulationIndex; }
+    constexpr bool isModulationParameter (int index) noexcept { return index >= firstModulationIndex && index < firstCutIndex; }
+    constexpr int getBand (int index) noexcept                { return index / numBandFields; }
+    constexpr BandField getBandField (int index) noexcept     { return (BandField) (index % numBandFields); }
+    constexpr ModulationField getModulationField (int index) noexcept
+    {
+        return (ModulationField) (index - firstModulationIndex);
+    }
+
+    constexpr iir::CutSlot getCutSlot (int index) noexcept    { return (iir::CutSlot) ((index - firstCutIndex) / numCutFields); }
+    constexpr CutField getCutField (int index) noexcept       { return (CutField) ((index - firstCutIndex) % numCutFields); }
+
+    constexpr bool isCutParameter (int index) noexcept        { return index >= firstCutIndex && index < firstDynamicsIndex; }
+    constexpr int getDynamicsBand (int index) noexcept        { return (index - firstDynamicsIndex) / numDynamicsFields; }
+    constexpr DynamicsField getDynamicsField (int index) noexcept
+    {
+        return (DynamicsField) ((index - firstDynamicsIndex) % numDynamicsFields);
+    }
+
+    constexpr bool isDynamicsParameter (int index) noexcept   { return index >= firstDynamicsIndex && index < firstHumIndex; }
+    constexpr bool isHumParameter (int index) noexcept        { return index >= firstHumIndex && index < firstResonatorIndex; }
+    constexpr HumField getHumField (int index) noexcept       { return (HumField) (index - firstHumIndex); }
+    constexpr bool isResonatorParameter (int index) noexcept  { return index >= firstResonatorIndex && index < firstCrossoverIndex; }
+    constexpr ResonatorField getResonatorField (int index) noexcept
+    {
+        return (ResonatorField) (index - firstResonatorIndex);
+    }
+    constexpr bool isCrossoverParameter (int index) noexcept  { return index >= firstCrossoverIndex && index < firstGlobalIndex; }
+    constexpr CrossoverField getCrossoverField (int index) noexcept
+    {
+        return (CrossoverField) (index - firstCrossoverIndex);
+    }
+    constexpr GlobalField getGlobalField (int index) noexcept { return (GlobalField) (index - firstGlobalIndex); }
+
+    /** The lower-case name of a field, e.g. "frequency". */
+    const char* getFieldName (BandField field) noexcept;
+    const char* getFieldName (ModulationField field) noexcept;
+    const char* getFieldName (CutField field) noexcept;
+    const char* getFieldName (DynamicsField field) noexcept;
+    const char* getFieldName (HumField field) noexcept;
+    const char* getFieldName (ResonatorField field) noexcept;
+    const char* getFieldName (CrossoverField field) noexcept;
+    const char* getFieldName (GlobalField field) noexcept;
+
+    /** A '/'-separated path such as "band/3/frequency", "modulation/lfoRate",
+        "lowCut/order", "band/3/dynamics/threshold", "hum/harmonics" or "global/midSide".
+    */
+    juce::String getPath (int index);
+
+    Range getRange (int index) noexcept;
+
+    /** The host's ID for a parameter, its path with '_' for '/', e.g.
+        "band_3_frequency". Hosts store sessions and automation under these, so
+        they must never change.
+    */
+    juce::String getId (int index);
+
+    /** The release that first gave the host a parameter, its ParameterID's
+        version hint. AU hosts order parameters by it, so a parameter added
+        later must get a higher one than every parameter before it, and no
+        parameter's may ever change.
+    */
+    int getVersionHint (int index) noexcept;
+
+    /** The name the host shows, e.g. "Band 3 frequency". */
+    juce::String getName (int index);
+
+    /** True for the on/off switches. */
+    bool isToggle (int index) noexcept;
+
+    /** The names of the values a parameter picks from, e.g. the filter types,
+        or an empty array if it isn't picked from a list.
+    */
+    juce::StringArray getChoices (int index);
+
+    /** Every parameter as a host parameter, in index order. */
+    juce::AudioProcessorValueTreeState::ParameterLayout createLayout();
+
+    /** The plain values of every parameter, by index. */
+    using Values = std::array<float, numParameters>;
+
+    /** Clamps the value to the parameter's range and writes it into the settings.
+        NaN and infinities are ignored: clamping wouldn't catch NaN, and either
+        would stay in every filter state they reached.
+    */
+    void apply (iir::FilterSettings& settings, int index, float value) noexcept;
+}
@@ -5,10 +5,22 @@
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAudioProcessor& p)
     : AudioProcessorEditor (&p), processorRef (p)
 {
-    juce::ignoreUnused (processorRef);
+    exportButton.onClick = [this] { exportTelemetry(); };
+    resetButton.onClick = [this] { processorRef.getTelemetry().reset(); };
+    loadModesButton.onClick = [this] { chooseModeTable(); };
+
+    addAndMakeVisible (exportButton);
+    addAndMakeVisible (resetButton);
+    addAndMakeVisible (loadModesButton);
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (400, 340);
+
+    // The first snapshot is taken on the first tick rather than here, so
+    // opening the editor costs no more than laying out its buttons. The
+    // meters want display rate; the telemetry only every few ticks
+    startTimerHz (meterRateHz);
 }
 
 AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor()
@@ -21,13 +33,110 @@ void AudioPluginAudioProcessorEditor::paint (juce::Graphics& g)
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
 
+    const auto& s = telemetrySnapshot;
+    auto micros = [] (double seconds) { return juce::String (seconds * 1.0e6, 1) + " us"; };
+    auto percent = [] (double load) { return juce::String (load * 100.0, 1) + " %"; };
+
+    juce::StringArray lines;
+    lines.add ("Blocks: " + juce::String ((juce::int64) s.numBlocks));
+    lines.add ("Mean: " + micros (s.getMeanSeconds()) + "   max: " + micros (s.maxSeconds));
+    lines.add ("p50: " + micros (s.getTimePercentile (50.0)) + "   (" + percent (s.getLoadPercentile (50.0)) + " of deadline)");
+    lines.add ("p99: " + micros (s.getTimePercentile (99.0)) + "   (" + percent (s.getLoadPercentile (99.0)) + ")");
+    lines.add ("p99.9: " + micros (s.getTimePercentile (99.9)) + "   (" + percent (s.getLoadPercentile (99.9)) + ")");
+    lines.add ("Max load: " + percent (s.maxLoad));
+
+    auto millis = [&s] (CpuTelemetry::Call call) { return juce::String (s.getCall (call).lastSeconds * 1.0e3, 2) + " ms"; };
+
+    lines.add ("Load: " + millis (CpuTelemetry::Call::construction)
+               + "   prepare: " + millis (CpuTelemetry::Call::prepareToPlay)
+               + "   editor: " + millis (CpuTelemetry::Call::createEditor)
+               + " (shown " + millis (CpuTelemetry::Call::editorOpen) + ")");
+    lines.add ("State save: " + millis (CpuTelemetry::Call::getState)
+               + "   restore: " + millis (CpuTelemetry::Call::setState));
+
+    auto decibels = [] (float gain) { return juce::String (juce::Decibels::gainToDecibels (gain, -100.0f), 1); };
+
+    for (int channel = 0; channel < processorRef.getMeter().getNumChannels(); ++channel)
+    {
+        const auto& level = levels[(size_t) channel];
+        lines.add ("Out " + juce::String (channel + 1) + ": peak " + decibels (level.peak)
+                   + "   RMS " + decibels (level.rms) + "   true peak " + decibels (level.truePeak) + " dBTP");
+    }
+
+    lines.add ("Resonator modes: " + juce::String (processorRef.getNumResonatorModes()));
+
+    if (modeStatus.isNotEmpty())
+        lines.add (modeStatus);
+
+    if (exportStatus.isNotEmpty())
+        lines.add (exportStatus);
+
     g.setColour (juce::Colours::white);
     g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
+    g.drawMultiLineText (lines.joinIntoString ("\n"), 16, 32, getWidth() - 32);
+
+    if (! hasPainted)
+    {
+        hasPainted = true;
+        const auto elapsed = juce::Time::getHighResolutionTicks() - openStart;
+        processorRef.getTelemetry().recordCall (CpuTelemetry::Call::editorOpen, juce::Time::highResolutionTicksToSeconds (elapsed));
+    }
 }
 
 void AudioPluginAudioProcessorEditor::resized()
 {
-    // This is generally where you'll want to lay out the positions of any
-    // subcomponents in your editor..
+    auto buttons = getLocalBounds().reduced (16).removeFromBottom (28);
+    exportButton.setBounds (buttons.removeFromLeft (160));
+    buttons.removeFromLeft (8);
+    resetButton.setBounds (buttons.removeFromLeft (80));
+    buttons.removeFromLeft (8);
+    loadModesButton.setBounds (buttons.removeFromLeft (110));
+}
+
+//==============================================================================
+void AudioPluginAudioProcessorEditor::timerCallback()
+{
+    auto& meter = processorRef.getMeter();
+
+    for (int channel = 0; channel < meter.getNumChannels(); ++channel)
+        levels[(size_t) channel] = meter.read (channel);
+
+    if (ticksSinceSnapshot == 0)
+        telemetrySnapshot = processorRef.getTelemetry().getSnapshot();
+
+    ticksSinceSnapshot = (ticksSinceSnapshot + 1) % (meterRateHz / telemetryRateHz);
+    repaint();
+}
+
+void AudioPluginAudioProcessorEditor::exportTelemetry()
+{
+    const auto folder = juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+                            .getChildFile (JucePlugin_Name)
+                            .getChildFile ("Telemetry");
+    folder.createDirectory();
+
+    const auto file = folder.getChildFile ("telemetry-" + juce::Time::getCurrentTime().formatted ("%Y%m%d-%H%M%S"));
+
+    exportStatus = processorRef.getTelemetry().exportTo (file) ? "Saved " + file.getFullPathName() + ".json/.csv"
+                                                               : "Couldn't write to " + folder.getFullPathName();
+    repaint();
+}
+
+void AudioPluginAudioProcessorEditor::chooseModeTable()
+{
+    modeChooser = std::make_unique<juce::FileChooser> ("Load a resonator mode table", juce::File(), "*.txt;*.csv");
+
+    modeChooser->launchAsync (juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                              [this] (const juce::FileChooser& chooser)
+    {
+        const auto file = chooser.getResult();
+
+        if (file == juce::File())
+            return;
+
+        const auto result = processorRef.loadModeTable (file.loadFileAsString());
+        modeStatus = result.wasOk() ? "Loaded " + file.getFileName()
+                                    : file.getFileName() + ": " + result.getErrorMessage();
+        repaint();
+    });
 }
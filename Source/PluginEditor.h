@@ -3,7 +3,8 @@
 #include "PluginProcessor.h"
 
 //==============================================================================
-class AudioPluginAudioProcessorEditor final : public juce::AudioProcessorEditor
+class AudioPluginAudioProcessorEditor final : public juce::AudioProcessorEditor,
+                                              private juce::Timer
 {
 public:
     explicit AudioPluginAudioProcessorEditor (AudioPluginAudioProcessor&);
@@ -14,9 +15,30 @@ public:
     void resized() override;
 
 private:
+    static constexpr int meterRateHz = 16;
+    static constexpr int telemetryRateHz = 4;
+
+    void timerCallback() override;
+    void exportTelemetry();
+    void chooseModeTable();
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     AudioPluginAudioProcessor& processorRef;
 
+    // Until the first paint, which is when the user actually sees the editor
+    const juce::int64 openStart = juce::Time::getHighResolutionTicks();
+    bool hasPainted = false;
+
+    CpuTelemetry::Snapshot telemetrySnapshot;
+    int ticksSinceSnapshot = 0;
+    std::array<iir::LevelMeter::Reading, iir::LevelMeter::maxChannels> levels {};
+
+    juce::TextButton exportButton { "Export telemetry" };
+    juce::TextButton resetButton { "Reset" };
+    juce::TextButton loadModesButton { "Load modes" };
+    std::unique_ptr<juce::FileChooser> modeChooser;
+    juce::String exportStatus, modeStatus;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessorEditor)
 };
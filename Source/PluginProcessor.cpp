@@ -1,21 +1,56 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+// The resonator mode table is saved with the parameters, as a property of their state
+static const juce::Identifier modeTableId { "modeTable" };
+
 //==============================================================================
+AudioPluginAudioProcessor::BusesProperties AudioPluginAudioProcessor::createBusesProperties()
+{
+    auto buses = BusesProperties()
+                #if ! JucePlugin_IsMidiEffect
+                 #if ! JucePlugin_IsSynth
+                  .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                  .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
+                 #endif
+                  .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                #endif
+                  ;
+
+   #if ! JucePlugin_IsMidiEffect
+    for (int band = 0; band < iir::maxCrossoverBands; ++band)
+        buses = buses.withOutput ("Band " + juce::String (band + 1), juce::AudioChannelSet::stereo(), false);
+   #endif
+
+    return buses;
+}
+
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       )
+     : AudioProcessor (createBusesProperties())
 {
+    for (int index = 0; index < Parameters::numParameters; ++index)
+    {
+        const auto id = Parameters::getId (index);
+        parameterValues[(size_t) index] = parameters.getRawParameterValue (id);
+        parameterObjects[(size_t) index] = parameters.getParameter (id);
+        jassert (parameterValues[(size_t) index] != nullptr && parameterObjects[(size_t) index] != nullptr);
+    }
+
+    // Nothing compares equal to NaN, so the first block applies every parameter
+    appliedValues.fill (std::numeric_limits<float>::quiet_NaN());
+
+    // Everything else that costs time or memory (the engine's state, the
+    // design and worker threads, the OSC socket and its address map, the
+    // echo timer) waits for prepareToPlay: hosts construct every plug-in
+    // they scan or find in a session, and most of those never play
+
+    const auto elapsed = juce::Time::getHighResolutionTicks() - constructionStart;
+    telemetry.recordCall (CpuTelemetry::Call::construction, juce::Time::highResolutionTicksToSeconds (elapsed));
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -53,7 +88,7 @@ bool AudioPluginAudioProcessor::isMidiEffect() const
 
 double AudioPluginAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailSeconds.load();
 }
 
 int AudioPluginAudioProcessor::getNumPrograms()
@@ -86,15 +121,54 @@ void AudioPluginAudioProcessor::changeProgramName (int index, const juce::String
 //==============================================================================
 void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    const CpuTelemetry::ScopedCallTimer callTimer (telemetry, CpuTelemetry::Call::prepareToPlay);
+
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
-    juce::ignoreUnused (sampleRate, samplesPerBlock);
+    // The band buses only receive copies of the main output, so everything
+    // is prepared for the main bus alone
+    const auto numChannels = getMainBusNumOutputChannels();
+    engine.prepare (sampleRate, samplesPerBlock, numChannels);
+
+    // Hosts prepare again on every transport or layout change; only log when the choice moves
+    const auto kernels = engine.describeKernels();
+
+    if (kernels != loggedKernels)
+    {
+        juce::Logger::writeToLog ("IIRFilters: " + kernels);
+        loggedKernels = kernels;
+    }
+
+    modulation.prepare (sampleRate, numChannels);
+    resonators.prepare (sampleRate, numChannels);
+    crossover.prepare (sampleRate, numChannels);
+    bypass.prepare (sampleRate, samplesPerBlock, numChannels, getLatencySamples());
+    meter.prepare (sampleRate, numChannels);
+
+    designService.start();
+    requestedSpecs = {};
+
+    // Only the first instance in a process gets the port; the others simply
+    // run without remote control.
+    if (! oscRemote.isConnected())
+        oscRemote.connect (OscRemote::defaultPort);
+
+    // Only remote changes are echoed to the host, so without a connection
+    // there is nothing to poll for
+    if (oscRemote.isConnected() && ! isTimerRunning())
+        startTimerHz (30);
 }
 
 void AudioPluginAudioProcessor::releaseResources()
 {
+    const CpuTelemetry::ScopedCallTimer callTimer (telemetry, CpuTelemetry::Call::releaseResources);
+
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    engine.release();
+    modulation.release();
+    resonators.release();
+    crossover.release();
 }
 
 bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -115,8 +189,28 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // The sidechain only keys the dynamic bands, so it can be off, mono or stereo
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto sidechain = layouts.getChannelSet (true, 1);
+
+        if (! sidechain.isDisabled()
+         && sidechain != juce::AudioChannelSet::mono()
+         && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
    #endif
 
+    // Each band bus carries the main output's channels
+    for (int bus = 1; bus < layouts.outputBuses.size(); ++bus)
+    {
+        const auto band = layouts.getChannelSet (false, bus);
+
+        if (! band.isDisabled() && band != layouts.getMainOutputChannelSet())
+            return false;
+    }
+
     return true;
   #endif
 }
@@ -125,10 +219,24 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                                               juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused (midiMessages);
+    process (buffer, false);
+}
+
+void AudioPluginAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer,
+                                                      juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused (midiMessages);
+    process (buffer, true);
+}
+
+void AudioPluginAudioProcessor::process (juce::AudioBuffer<float>& buffer, bool bypassed) noexcept
+{
+    const CpuTelemetry::ScopedBlockTimer blockTimer (telemetry, buffer.getNumSamples(), getSampleRate());
 
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    auto totalNumInputChannels  = getMainBusNumInputChannels();
+    auto totalNumOutputChannels = getMainBusNumOutputChannels();
+    const auto numSamples = buffer.getNumSamples();
 
     // In case we have more outputs than inputs, this code clears any output
     // channels that didn't contain input data, (because these aren't
@@ -137,20 +245,216 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     // when they first compile a plugin, but obviously you don't need to keep
     // this code if your algorithm always overwrites all the output channels.
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
-
-    // This is the place where you'd normally do the guts of your plugin's
-    // audio processing...
-    // Make sure to reset the state if your inner loop is processing
-    // the samples and the outer loop is handling the channels.
-    // Alternatively, you can process the samples with the channels
-    // interleaved by keeping the same state.
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+        buffer.clear (i, 0, numSamples);
+
+    // Parameters and cut designs stay current while bypassed, so nothing is
+    // stale when the filters are heard again
+    auto numChanges = applyParameterChanges();
+
+    // Apply whatever arrived over OSC since the last block, at most once per
+    // parameter, and have the message thread move the host's parameter to match
+    numChanges += parameterQueue.drain ([this] (int index, float value)
+    {
+        Parameters::apply (settings, index, value);
+        hostEchoQueue.push (index, value);
+    });
+
+    if (numChanges > 0)
     {
-        auto* channelData = buffer.getWritePointer (channel);
-        juce::ignoreUnused (channelData);
-        // ..do something to the data...
+        engine.setSettings (settings);
+        modulation.setSettings (settings.modulation);
+        crossover.setSettings (settings.crossover);
     }
+
+    updateCutFilters();
+    updateTailLength();
+
+    auto* const* channels = buffer.getArrayOfWritePointers();
+
+    if (bypass.setBypassed (bypassed) && ! settings.warmBypass)
+    {
+        // Fade in from silence rather than from wherever the filters stopped
+        engine.reset();
+        modulation.reset();
+        resonators.reset();
+    }
+
+    // A longer block than the host announced switches without fading
+    const auto canFade = bypass.canFade (numSamples);
+
+    if (! canFade)
+        bypass.reset();
+
+    // Fully bypassed and not keeping warm, only the latency is left to apply
+    if (bypass.isFullyBypassed() && (! settings.warmBypass || ! canFade))
+    {
+        bypass.passThrough (channels, totalNumInputChannels, numSamples);
+        finishBlock (buffer, totalNumInputChannels);
+        return;
+    }
+
+    const auto mixWithDry = canFade && bypass.needsDry();
+
+    if (mixWithDry)
+        bypass.capture (channels, totalNumInputChannels, numSamples);
+
+    const auto sidechain = getBusCount (true) > 1 ? getBusBuffer (buffer, true, 1) : juce::AudioBuffer<float>();
+
+    engine.process (channels, totalNumInputChannels, numSamples,
+                    sidechain.getArrayOfReadPointers(), sidechain.getNumChannels());
+    modulation.process (channels, totalNumInputChannels, numSamples);
+
+    if (settings.resonator.enabled)
+        resonators.process (channels, totalNumInputChannels, numSamples, settings.resonator.mix);
+
+    if (mixWithDry)
+        bypass.mix (channels, totalNumInputChannels, numSamples);
+
+    finishBlock (buffer, totalNumInputChannels);
+}
+
+void AudioPluginAudioProcessor::finishBlock (juce::AudioBuffer<float>& buffer, int numChannels) noexcept
+{
+    // Metered as heard, after the bypass fade, while the block is still in cache
+    meter.process (buffer.getArrayOfReadPointers(), numChannels, buffer.getNumSamples());
+    splitIntoBands (buffer, numChannels);
+}
+
+void AudioPluginAudioProcessor::splitIntoBands (juce::AudioBuffer<float>& buffer, int numChannels) noexcept
+{
+    // The band buses share the buffer with the inputs, the sidechain included,
+    // so they are only written once the main output is finished. Every enabled
+    // band bus is written or cleared, as its channels hold input or garbage
+    const auto numSamples = buffer.getNumSamples();
+    const auto numBands = crossover.getNumBands();
+
+    std::array<std::array<float*, 2>, iir::maxCrossoverBands> bandChannels {};
+    std::array<float* const*, iir::maxCrossoverBands> bands {};
+
+    for (int band = 0; band < iir::maxCrossoverBands; ++band)
+    {
+        auto* bus = getBus (false, band + 1);
+
+        if (bus == nullptr || ! bus->isEnabled())
+            continue;
+
+        const auto first = bus->getChannelIndexInProcessBlockBuffer (0);
+
+        if (band < numBands && bus->getNumberOfChannels() == numChannels)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                bandChannels[(size_t) band][(size_t) channel] = buffer.getWritePointer (first + channel);
+
+            bands[(size_t) band] = bandChannels[(size_t) band].data();
+        }
+        else
+        {
+            for (int channel = 0; channel < bus->getNumberOfChannels(); ++channel)
+                buffer.clear (first + channel, 0, numSamples);
+        }
+    }
+
+    crossover.process (buffer.getArrayOfReadPointers(), numChannels, numSamples, bands.data());
+}
+
+int AudioPluginAudioProcessor::applyParameterChanges() noexcept
+{
+    // One relaxed load per parameter per block, however many there are; only
+    // the parameters that moved reach the settings, and the engine then only
+    // redesigns the bands whose settings changed
+    Parameters::Values values;
+
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = parameterValues[i]->load (std::memory_order_relaxed);
+
+    int numChanges = 0;
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (values[i] != appliedValues[i])
+        {
+            Parameters::apply (settings, (int) i, values[i]);
+            ++numChanges;
+        }
+    }
+
+    appliedValues = values;
+    return numChanges;
+}
+
+void AudioPluginAudioProcessor::timerCallback()
+{
+    hostEchoQueue.drain ([this] (int index, float value)
+    {
+        auto* parameter = parameterObjects[(size_t) index];
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    });
+}
+
+void AudioPluginAudioProcessor::updateCutFilters() noexcept
+{
+    for (int slot = 0; slot < iir::numCutSlots; ++slot)
+    {
+        const auto& cut = settings.cuts[(size_t) slot];
+
+        if (! cut.enabled)
+        {
+            engine.setCascade (slot, nullptr);
+            supersededDesigns[(size_t) slot] = designService.acquire (slot);
+            continue;
+        }
+
+        const auto spec = iir::CascadeSpec::fromSettings (cut, slot == iir::lowCut, getSampleRate());
+
+        // The default cuts at the standard rates were designed when the library loaded
+        // and run from the first block
+        if (const auto* preset = iir::DesignTables::findCascade (spec))
+        {
+            engine.setCascade (slot, spec, *preset);
+            supersededDesigns[(size_t) slot] = designService.acquire (slot);
+            continue;
+        }
+
+        // If the mailbox is full the request is simply repeated next block
+        if (spec != requestedSpecs[(size_t) slot] && designService.request (slot, spec))
+            requestedSpecs[(size_t) slot] = spec;
+
+        // Whatever is running - a preset, the previous design, or nothing if
+        // the cut was just switched on - keeps running until the service
+        // publishes a design newer than it. Designs from another sample rate
+        // are left over from before the last prepareToPlay.
+        const auto* design = designService.acquire (slot);
+        auto& superseded = supersededDesigns[(size_t) slot];
+
+        if (design != nullptr
+             && (design->spec == spec || (design != superseded && design->spec.sampleRate == spec.sampleRate)))
+        {
+            engine.setCascade (slot, design);
+            superseded = nullptr;
+        }
+    }
+}
+
+void AudioPluginAudioProcessor::updateTailLength() noexcept
+{
+    // The engine, the modulated band and the resonators run in series, and
+    // the crossover after them; the sum of their tails bounds the whole.
+    // The modulated band is taken at its unmodulated cutoff
+    auto samples = engine.getTailSamples() + crossover.getTailSamples();
+
+    if (settings.modulation.enabled)
+    {
+        iir::BandSettings band;
+        band.enabled = true;
+        band.type = settings.modulation.type;
+        band.frequency = settings.modulation.frequency;
+        band.q = settings.modulation.q;
+        band.gainDb = settings.modulation.gainDb;
+        samples += iir::BiquadCoefficients<double>::design (band, getSampleRate()).getDecaySamples();
+    }
+
+    const auto resonatorSeconds = settings.resonator.enabled ? resonators.getTailSeconds() : 0.0;
+    tailSeconds.store (samples / getSampleRate() + resonatorSeconds);
 }
 
 //==============================================================================
@@ -161,23 +465,46 @@ bool AudioPluginAudioProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor()
 {
+    const CpuTelemetry::ScopedCallTimer callTimer (telemetry, CpuTelemetry::Call::createEditor);
     return new AudioPluginAudioProcessorEditor (*this);
 }
 
 //==============================================================================
 void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-    juce::ignoreUnused (destData);
+    const CpuTelemetry::ScopedCallTimer callTimer (telemetry, CpuTelemetry::Call::getState);
+
+    if (const auto xml = parameters.copyState().createXml())
+        copyXmlToBinary (*xml, destData);
 }
 
 void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-    juce::ignoreUnused (data, sizeInBytes);
+    const CpuTelemetry::ScopedCallTimer callTimer (telemetry, CpuTelemetry::Call::setState);
+
+    if (const auto xml = getXmlFromBinary (data, sizeInBytes))
+        if (xml->hasTagName (parameters.state.getType()))
+            parameters.replaceState (juce::ValueTree::fromXml (*xml));
+
+    std::vector<iir::ResonatorBank::Mode> modes;
+    const auto modeTable = parameters.state.getProperty (modeTableId).toString();
+
+    if (modeTable.isNotEmpty() && iir::ResonatorBank::parseModes (modeTable, modes).wasOk())
+        resonators.setModes (std::move (modes));
+}
+
+juce::Result AudioPluginAudioProcessor::loadModeTable (const juce::String& text)
+{
+    std::vector<iir::ResonatorBank::Mode> modes;
+    const auto result = iir::ResonatorBank::parseModes (text, modes);
+
+    if (result.wasOk())
+    {
+        resonators.setModes (std::move (modes));
+        parameters.state.setProperty (modeTableId, text, nullptr);
+    }
+
+    return result;
 }
 
 //==============================================================================
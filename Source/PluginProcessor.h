@@ -2,8 +2,20 @@
 
 #include <JuceHeader.h>
 
+#include "DSP/BypassCrossfade.h"
+#include "DSP/CascadeDesignService.h"
+#include "DSP/Crossover.h"
+#include "DSP/FilterEngine.h"
+#include "DSP/LevelMeter.h"
+#include "DSP/ModulationEngine.h"
+#include "DSP/ResonatorBank.h"
+#include "Parameters.h"
+#include "Remote/OscRemote.h"
+#include "Telemetry/CpuTelemetry.h"
+
 //==============================================================================
-class AudioPluginAudioProcessor final : public juce::AudioProcessor
+class AudioPluginAudioProcessor final : public juce::AudioProcessor,
+                                        private juce::Timer
 {
 public:
     //==============================================================================
@@ -17,7 +29,9 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
     using AudioProcessor::processBlock;
+    using AudioProcessor::processBlockBypassed;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -42,7 +56,78 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    CpuTelemetry& getTelemetry() noexcept  { return telemetry; }
+
+    juce::AudioProcessorValueTreeState& getParameters() noexcept  { return parameters; }
+
+    /** Loads a resonator mode table (see iir::ResonatorBank::parseModes) and
+        keeps it in the state, so it is saved with the session. Call from the
+        message thread.
+    */
+    juce::Result loadModeTable (const juce::String& text);
+
+    int getNumResonatorModes() const noexcept  { return resonators.getNumModes(); }
+
+    /** The main output's levels, for the editor to read at display rate. */
+    iir::LevelMeter& getMeter() noexcept  { return meter; }
+
 private:
+    //==============================================================================
+    /** The main output, then one bus per crossover band, off until the host enables it. */
+    static BusesProperties createBusesProperties();
+
+    void process (juce::AudioBuffer<float>&, bool bypassed) noexcept;
+    void finishBlock (juce::AudioBuffer<float>&, int numChannels) noexcept;
+    void splitIntoBands (juce::AudioBuffer<float>&, int numChannels) noexcept;
+    int applyParameterChanges() noexcept;
+    void updateCutFilters() noexcept;
+    void updateTailLength() noexcept;
+    void timerCallback() override;
+
+    //==============================================================================
+    // First, so the construction time covers every member after it
+    const juce::int64 constructionStart = juce::Time::getHighResolutionTicks();
+
+    juce::AudioProcessorValueTreeState parameters { *this, nullptr, "IIRFilters", Parameters::createLayout() };
+
+    // Looked up once, by index, so processBlock never searches by ID
+    std::array<std::atomic<float>*, Parameters::numParameters> parameterValues {};
+    std::array<juce::RangedAudioParameter*, Parameters::numParameters> parameterObjects {};
+
+    // The values the settings were last brought up to date with
+    Parameters::Values appliedValues {};
+
+    // Remote control: OSC messages land in the queue and are drained in
+    // processBlock, which passes them on through the echo queue for the
+    // message thread to set on the host's parameters
+    ParameterQueue parameterQueue { Parameters::numParameters };
+    ParameterQueue hostEchoQueue { Parameters::numParameters };
+    OscRemote oscRemote { parameterQueue };
+
+    // Audio-thread state
+    iir::FilterSettings settings;
+    iir::FilterEngine engine;
+    iir::ModulationEngine modulation;
+    iir::ResonatorBank resonators;
+    iir::Crossover crossover;
+    iir::BypassCrossfade bypass;
+    iir::LevelMeter meter;
+
+    // Steep cuts are designed on a background thread and picked up per block
+    iir::CascadeDesignService designService;
+    std::array<iir::CascadeSpec, iir::numCutSlots> requestedSpecs;
+
+    // What the service had published when a slot last went over to a preset
+    // or off: older than what the slot has run since, so never picked up again
+    std::array<const iir::CascadeDesign*, iir::numCutSlots> supersededDesigns {};
+
+    // Worked out on the audio thread from what it is running, read by the host from any thread
+    std::atomic<double> tailSeconds { 0.0 };
+
+    CpuTelemetry telemetry;
+    juce::String loggedKernels;
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessor)
 };
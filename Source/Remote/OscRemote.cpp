@@ -0,0 +1,92 @@
+#include "OscRemote.h"
+#include "../Parameters.h"
+
+//==============================================================================
+OscRemote::OscRemote (ParameterQueue& queueToUse)
+    : queue (queueToUse)
+{
+    jassert (queue.getNumParameters() >= Parameters::numParameters);
+    receiver.addListener (this);
+}
+
+OscRemote::~OscRemote()
+{
+    receiver.removeListener (this);
+    disconnect();
+}
+
+//==============================================================================
+bool OscRemote::connect (int portNumber)
+{
+    if (connectedPort == portNumber)
+        return true;
+
+    disconnect();
+
+    // Built on first use: most instances, and every one a plug-in scan
+    // creates, never listen at all
+    if (addressMap.size() == 0)
+        for (int index = 0; index < Parameters::numParameters; ++index)
+            addressMap.set ("/iirfilters/" + Parameters::getPath (index), index);
+
+    // OSCReceiver::connect() would listen on every interface
+    auto newSocket = std::make_unique<juce::DatagramSocket> (false);
+
+    if (! newSocket->bindToPort (portNumber, "127.0.0.1") || ! receiver.connectToSocket (*newSocket))
+        return false;
+
+    socket = std::move (newSocket);
+    connectedPort = portNumber;
+    return true;
+}
+
+void OscRemote::disconnect()
+{
+    if (connectedPort > 0)
+    {
+        // The receiver stops reading before the socket it borrowed goes
+        receiver.disconnect();
+        socket->shutdown();
+        socket.reset();
+        connectedPort = 0;
+    }
+}
+
+int OscRemote::getParameterIndex (const juce::String& address) const
+{
+    return addressMap.getWithDefault (address, -1);
+}
+
+//==============================================================================
+void OscRemote::oscMessageReceived (const juce::OSCMessage& message)
+{
+    if (message.size() != 1)
+        return;
+
+    const auto index = getParameterIndex (message.getAddressPattern().toString());
+
+    if (index < 0)
+        return;
+
+    const auto& argument = message[0];
+
+    // NaN or an infinity would get past the clamp and into the filter states
+    if (argument.isFloat32())
+    {
+        if (std::isfinite (argument.getFloat32()))
+            queue.push (index, argument.getFloat32());
+    }
+    else if (argument.isInt32())
+        queue.push (index, (float) argument.getInt32());
+}
+
+void OscRemote::oscBundleReceived (const juce::OSCBundle& bundle)
+{
+    for (const auto& element : bundle)
+    {
+        if (element.isMessage())
+            oscMessageReceived (element.getMessage());
+        else if (element.isBundle())
+            oscBundleReceived (element.getBundle());
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ParameterQueue.h"
+
+//==============================================================================
+/** Listens for OSC messages and forwards them to the audio thread.
+
+    Addresses have the form /iirfilters/<path>, where path comes from
+    Parameters::getPath() (e.g. /iirfilters/band/3/frequency), and carry a
+    single float or int argument in the parameter's natural unit (Hz, dB, ...).
+    Bundles are unpacked recursively.
+
+    Messages are handled directly on the receiver's network thread and pushed
+    into a ParameterQueue, so neither the message thread nor the audio thread
+    ever sees individual OSC traffic.
+*/
+class OscRemote final : private juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
+{
+public:
+    explicit OscRemote (ParameterQueue& queueToUse);
+    ~OscRemote() override;
+
+    static constexpr int defaultPort = 9001;
+
+    /** Starts listening on the given UDP port, on the loopback interface only,
+        so nothing else on the network can drive the plug-in. Returns false if
+        the port is unavailable, e.g. because another instance already owns it.
+    */
+    bool connect (int portNumber);
+    void disconnect();
+
+    bool isConnected() const noexcept  { return connectedPort > 0; }
+    int getPort() const noexcept       { return connectedPort; }
+
+    /** Returns the parameter index for an address, or -1 if it isn't mapped. */
+    int getParameterIndex (const juce::String& address) const;
+
+private:
+    //==============================================================================
+    void oscMessageReceived (const juce::OSCMessage&) override;
+    void oscBundleReceived (const juce::OSCBundle&) override;
+
+    ParameterQueue& queue;
+    juce::OSCReceiver receiver;
+    std::unique_ptr<juce::DatagramSocket> socket;
+    juce::HashMap<juce::String, int> addressMap;
+    int connectedPort = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OscRemote)
+};
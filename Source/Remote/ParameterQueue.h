@@ -0,0 +1,90 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** A bounded, lock-free, single-producer/single-consumer queue of parameter
+    changes that coalesces bursts.
+
+    The producer writes the latest value of a parameter into a per-parameter
+    slot and only enqueues the parameter's index if it isn't already waiting.
+    However many messages arrive between two audio blocks, each parameter is
+    therefore queued at most once, so the FIFO can never overflow and the
+    audio thread's work per block is bounded by the number of parameters.
+
+    (An index can be re-queued while the consumer is still walking over its
+    old slot, which is why the FIFO holds two entries per parameter.)
+*/
+class ParameterQueue
+{
+public:
+    explicit ParameterQueue (int numParametersToHold)
+        : values ((size_t) numParametersToHold),
+          pending ((size_t) numParametersToHold),
+          fifo (2 * numParametersToHold + 1),
+          indices ((size_t) (2 * numParametersToHold + 1))
+    {
+    }
+
+    int getNumParameters() const noexcept  { return (int) values.size(); }
+
+    /** Producer side. Must only be called from one thread at a time. */
+    void push (int index, float value) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (index, getNumParameters()));
+
+        values[(size_t) index].store (value);
+
+        // Already queued: the consumer will pick up the value we just stored
+        if (pending[(size_t) index].exchange (true))
+            return;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+        jassert (size1 + size2 == 1);
+
+        if (size1 > 0)       indices[(size_t) start1] = index;
+        else if (size2 > 0)  indices[(size_t) start2] = index;
+
+        fifo.finishedWrite (size1 + size2);
+    }
+
+    /** Consumer side, meant to be called once per audio block.
+        Calls callback (index, value) for every parameter that changed since the
+        last call and returns how many there were.
+    */
+    template <typename Callback>
+    int drain (Callback&& callback) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+        auto handle = [&] (int start, int size)
+        {
+            for (int i = start; i < start + size; ++i)
+            {
+                const auto index = indices[(size_t) i];
+
+                // Clear the flag before reading, so a value written after this
+                // point re-queues the parameter instead of being lost
+                pending[(size_t) index].store (false);
+                callback (index, values[(size_t) index].load());
+            }
+        };
+
+        handle (start1, size1);
+        handle (start2, size2);
+
+        fifo.finishedRead (size1 + size2);
+        return size1 + size2;
+    }
+
+private:
+    //==============================================================================
+    std::vector<std::atomic<float>> values;
+    std::vector<std::atomic<bool>> pending;
+    juce::AbstractFifo fifo;
+    std::vector<int> indices;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterQueue)
+};
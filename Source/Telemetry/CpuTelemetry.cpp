@@ -0,0 +1,261 @@
+#include "CpuTelemetry.h"
+
+namespace
+{
+    // Bucket b covers [2^((b + offset) / 8), 2^((b + offset + 1) / 8)), in
+    // nanoseconds for the time histogram and in deadlines for the load histogram
+    constexpr int bucketsPerOctave = 8;
+    constexpr int timeBucketOffset = 6 * bucketsPerOctave;
+    constexpr int loadBucketOffset = -17 * bucketsPerOctave;
+
+    int getLogBucket (double value, int offset, int numBuckets) noexcept
+    {
+        if (value <= 0.0)
+            return 0;
+
+        const auto bucket = (int) std::floor (std::log2 (value) * bucketsPerOctave) - offset;
+        return juce::jlimit (0, numBuckets - 1, bucket);
+    }
+
+    double getLogBucketStart (int bucket, int offset) noexcept
+    {
+        return std::exp2 ((double) (bucket + offset) / bucketsPerOctave);
+    }
+
+    template <size_t N>
+    int findPercentileBucket (const std::array<juce::uint64, N>& counts, juce::uint64 total, double percentile) noexcept
+    {
+        if (total == 0)
+            return -1;
+
+        const auto target = (juce::uint64) std::ceil (juce::jlimit (0.0, 100.0, percentile) * 0.01 * (double) total);
+        juce::uint64 seen = 0;
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            seen += counts[i];
+
+            if (seen >= juce::jmax ((juce::uint64) 1, target))
+                return (int) i;
+        }
+
+        return (int) N - 1;
+    }
+}
+
+//==============================================================================
+const char* CpuTelemetry::getCallName (Call call) noexcept
+{
+    switch (call)
+    {
+        case Call::construction:        return "construction";
+        case Call::prepareToPlay:       return "prepareToPlay";
+        case Call::releaseResources:    return "releaseResources";
+        case Call::getState:            return "getStateInformation";
+        case Call::setState:            return "setStateInformation";
+        case Call::createEditor:        return "createEditor";
+        case Call::editorOpen:          return "editorOpen";
+    }
+
+    return "";
+}
+
+int CpuTelemetry::getTimeBucket (double seconds) noexcept
+{
+    return getLogBucket (seconds * 1.0e9, timeBucketOffset, numTimeBuckets);
+}
+
+int CpuTelemetry::getLoadBucket (double load) noexcept
+{
+    return getLogBucket (load, loadBucketOffset, numLoadBuckets);
+}
+
+double CpuTelemetry::getTimeBucketStart (int bucket) noexcept
+{
+    return getLogBucketStart (bucket, timeBucketOffset) * 1.0e-9;
+}
+
+double CpuTelemetry::getLoadBucketStart (int bucket) noexcept
+{
+    return getLogBucketStart (bucket, loadBucketOffset);
+}
+
+void CpuTelemetry::record (double blockSeconds, double deadlineSeconds) noexcept
+{
+    // Checked with a plain load first, so the common case is no RMW at all
+    if (resetRequested.load (std::memory_order_relaxed) && resetRequested.exchange (false, std::memory_order_acquire))
+    {
+        for (auto& c : timeCounts)  c.store (0, std::memory_order_relaxed);
+        for (auto& c : loadCounts)  c.store (0, std::memory_order_relaxed);
+
+        totalSeconds.store (0.0, std::memory_order_relaxed);
+        maxSeconds.store (0.0, std::memory_order_relaxed);
+        maxLoad.store (0.0, std::memory_order_relaxed);
+    }
+
+    const auto load = deadlineSeconds > 0.0 ? blockSeconds / deadlineSeconds : 0.0;
+
+    increment (timeCounts[(size_t) getTimeBucket (blockSeconds)], (juce::uint64) 1);
+    increment (loadCounts[(size_t) getLoadBucket (load)], (juce::uint64) 1);
+    increment (totalSeconds, blockSeconds);
+
+    if (blockSeconds > maxSeconds.load (std::memory_order_relaxed))
+        maxSeconds.store (blockSeconds, std::memory_order_relaxed);
+
+    if (load > maxLoad.load (std::memory_order_relaxed))
+        maxLoad.store (load, std::memory_order_relaxed);
+}
+
+void CpuTelemetry::recordCall (Call call, double seconds) noexcept
+{
+    auto& c = calls[(size_t) call];
+
+    increment (c.count, (juce::uint64) 1);
+    increment (c.totalSeconds, seconds);
+    c.lastSeconds.store (seconds, std::memory_order_relaxed);
+
+    if (seconds > c.maxSeconds.load (std::memory_order_relaxed))
+        c.maxSeconds.store (seconds, std::memory_order_relaxed);
+}
+
+CpuTelemetry::Snapshot CpuTelemetry::getSnapshot() const noexcept
+{
+    Snapshot s;
+
+    for (size_t i = 0; i < timeCounts.size(); ++i)
+        s.timeCounts[i] = timeCounts[i].load (std::memory_order_relaxed);
+
+    for (size_t i = 0; i < loadCounts.size(); ++i)
+        s.loadCounts[i] = loadCounts[i].load (std::memory_order_relaxed);
+
+    // Derive the count from the histogram so percentiles are self-consistent
+    s.numBlocks = std::accumulate (s.timeCounts.begin(), s.timeCounts.end(), (juce::uint64) 0);
+    s.totalSeconds = totalSeconds.load (std::memory_order_relaxed);
+    s.maxSeconds = maxSeconds.load (std::memory_order_relaxed);
+    s.maxLoad = maxLoad.load (std::memory_order_relaxed);
+
+    for (size_t i = 0; i < calls.size(); ++i)
+    {
+        s.calls[i].count = calls[i].count.load (std::memory_order_relaxed);
+        s.calls[i].lastSeconds = calls[i].lastSeconds.load (std::memory_order_relaxed);
+        s.calls[i].maxSeconds = calls[i].maxSeconds.load (std::memory_order_relaxed);
+        s.calls[i].totalSeconds = calls[i].totalSeconds.load (std::memory_order_relaxed);
+    }
+
+    return s;
+}
+
+void CpuTelemetry::reset() noexcept
+{
+    resetRequested.store (true, std::memory_order_release);
+}
+
+//==============================================================================
+double CpuTelemetry::Snapshot::getTimePercentile (double percentile) const noexcept
+{
+    const auto bucket = findPercentileBucket (timeCounts, numBlocks, percentile);
+
+    // Report the geometric middle of the bucket
+    return bucket < 0 ? 0.0 : std::sqrt (getTimeBucketStart (bucket) * getTimeBucketStart (bucket + 1));
+}
+
+double CpuTelemetry::Snapshot::getLoadPercentile (double percentile) const noexcept
+{
+    const auto total = std::accumulate (loadCounts.begin(), loadCounts.end(), (juce::uint64) 0);
+    const auto bucket = findPercentileBucket (loadCounts, total, percentile);
+    return bucket < 0 ? 0.0 : std::sqrt (getLoadBucketStart (bucket) * getLoadBucketStart (bucket + 1));
+}
+
+juce::String CpuTelemetry::Snapshot::toJson() const
+{
+    auto summary = std::make_unique<juce::DynamicObject>();
+    summary->setProperty ("blocks", (juce::int64) numBlocks);
+    summary->setProperty ("meanSeconds", getMeanSeconds());
+    summary->setProperty ("maxSeconds", maxSeconds);
+    summary->setProperty ("p50Seconds", getTimePercentile (50.0));
+    summary->setProperty ("p99Seconds", getTimePercentile (99.0));
+    summary->setProperty ("p999Seconds", getTimePercentile (99.9));
+    summary->setProperty ("p50Load", getLoadPercentile (50.0));
+    summary->setProperty ("p99Load", getLoadPercentile (99.0));
+    summary->setProperty ("p999Load", getLoadPercentile (99.9));
+    summary->setProperty ("maxLoad", maxLoad);
+
+    juce::Array<juce::var> timeHistogram, loadHistogram;
+
+    for (int i = 0; i < numTimeBuckets; ++i)
+    {
+        if (timeCounts[(size_t) i] == 0)
+            continue;
+
+        auto bucket = std::make_unique<juce::DynamicObject>();
+        bucket->setProperty ("fromSeconds", getTimeBucketStart (i));
+        bucket->setProperty ("toSeconds", getTimeBucketStart (i + 1));
+        bucket->setProperty ("count", (juce::int64) timeCounts[(size_t) i]);
+        timeHistogram.add (juce::var (bucket.release()));
+    }
+
+    for (int i = 0; i < numLoadBuckets; ++i)
+    {
+        if (loadCounts[(size_t) i] == 0)
+            continue;
+
+        auto bucket = std::make_unique<juce::DynamicObject>();
+        bucket->setProperty ("fromLoad", getLoadBucketStart (i));
+        bucket->setProperty ("toLoad", getLoadBucketStart (i + 1));
+        bucket->setProperty ("count", (juce::int64) loadCounts[(size_t) i]);
+        loadHistogram.add (juce::var (bucket.release()));
+    }
+
+    auto hostCalls = std::make_unique<juce::DynamicObject>();
+
+    for (int i = 0; i < numCalls; ++i)
+    {
+        const auto& c = calls[(size_t) i];
+
+        if (c.count == 0)
+            continue;
+
+        auto call = std::make_unique<juce::DynamicObject>();
+        call->setProperty ("count", (juce::int64) c.count);
+        call->setProperty ("lastSeconds", c.lastSeconds);
+        call->setProperty ("meanSeconds", c.getMeanSeconds());
+        call->setProperty ("maxSeconds", c.maxSeconds);
+        hostCalls->setProperty (getCallName ((Call) i), juce::var (call.release()));
+    }
+
+    auto root = std::make_unique<juce::DynamicObject>();
+    root->setProperty ("summary", juce::var (summary.release()));
+    root->setProperty ("hostCalls", juce::var (hostCalls.release()));
+    root->setProperty ("timeHistogram", timeHistogram);
+    root->setProperty ("loadHistogram", loadHistogram);
+
+    return juce::JSON::toString (juce::var (root.release()));
+}
+
+juce::String CpuTelemetry::Snapshot::toCsv() const
+{
+    juce::String csv;
+    csv << "kind,from,to,count\n";
+
+    for (int i = 0; i < numTimeBuckets; ++i)
+        if (timeCounts[(size_t) i] > 0)
+            csv << "seconds," << getTimeBucketStart (i) << "," << getTimeBucketStart (i + 1)
+                << "," << (juce::int64) timeCounts[(size_t) i] << "\n";
+
+    for (int i = 0; i < numLoadBuckets; ++i)
+        if (loadCounts[(size_t) i] > 0)
+            csv << "load," << getLoadBucketStart (i) << "," << getLoadBucketStart (i + 1)
+                << "," << (juce::int64) loadCounts[(size_t) i] << "\n";
+
+    return csv;
+}
+
+bool CpuTelemetry::exportTo (const juce::File& fileWithoutExtension) const
+{
+    const auto snapshot = getSnapshot();
+
+    const auto wroteJson = fileWithoutExtension.withFileExtension ("json").replaceWithText (snapshot.toJson());
+    const auto wroteCsv  = fileWithoutExtension.withFileExtension ("csv").replaceWithText (snapshot.toCsv());
+
+    return wroteJson && wroteCsv;
+}
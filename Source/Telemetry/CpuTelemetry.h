@@ -0,0 +1,185 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Per-instance processing-time statistics, gathered on the audio thread.
+
+    Every processBlock() call is timed and recorded into two histograms with
+    1/8-octave buckets: the time per block, and the share of the block's
+    real-time deadline it used. Recording is a handful of
+    relaxed atomic stores with a single writer, so it costs next to nothing and
+    never blocks. Any thread can take a Snapshot and read the percentiles from
+    it, or export it as JSON/CSV.
+
+    The calls a host makes around processing - construction, prepareToPlay(),
+    state save and restore, opening the editor - are timed too. They are
+    measured inside the plug-in, so they include whatever the host and the
+    plug-in wrapper do in between, and match what a real session sees rather
+    than what a benchmark of the DSP alone would.
+*/
+class CpuTelemetry
+{
+public:
+    CpuTelemetry() = default;
+
+    static constexpr int numTimeBuckets = 192;      // 64 ns .. ~1 s
+    static constexpr int numLoadBuckets = 160;      // ~0.0008 % .. 800 % of the deadline
+
+    /** The host calls whose duration is recorded. */
+    enum class Call
+    {
+        construction,
+        prepareToPlay,
+        releaseResources,
+        getState,
+        setState,
+        createEditor,
+        editorOpen      // from the editor's construction to its first paint
+    };
+
+    static constexpr int numCalls = 7;
+
+    static const char* getCallName (Call call) noexcept;
+
+    //==============================================================================
+    /** Audio thread: records one block. */
+    void record (double blockSeconds, double deadlineSeconds) noexcept;
+
+    /** Times the enclosing scope and records it when it ends. */
+    class ScopedBlockTimer
+    {
+    public:
+        ScopedBlockTimer (CpuTelemetry& t, int numSamples, double sampleRate) noexcept
+            : telemetry (t),
+              deadlineSeconds (sampleRate > 0.0 ? numSamples / sampleRate : 0.0),
+              start (juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedBlockTimer()
+        {
+            const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+            telemetry.record (juce::Time::highResolutionTicksToSeconds (elapsed), deadlineSeconds);
+        }
+
+    private:
+        CpuTelemetry& telemetry;
+        double deadlineSeconds;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBlockTimer)
+    };
+
+    //==============================================================================
+    /** Records one host call. Hosts make these one at a time, so this is
+        only ever called by one thread at once, though not always the same one.
+    */
+    void recordCall (Call call, double seconds) noexcept;
+
+    /** Times the enclosing scope as one host call. */
+    class ScopedCallTimer
+    {
+    public:
+        ScopedCallTimer (CpuTelemetry& t, Call c) noexcept
+            : telemetry (t), call (c), start (juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedCallTimer()
+        {
+            const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+            telemetry.recordCall (call, juce::Time::highResolutionTicksToSeconds (elapsed));
+        }
+
+    private:
+        CpuTelemetry& telemetry;
+        Call call;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedCallTimer)
+    };
+
+    //==============================================================================
+    struct CallStats
+    {
+        juce::uint64 count = 0;
+        double lastSeconds = 0.0, maxSeconds = 0.0, totalSeconds = 0.0;
+
+        double getMeanSeconds() const noexcept  { return count > 0 ? totalSeconds / (double) count : 0.0; }
+    };
+
+    struct Snapshot
+    {
+        std::array<juce::uint64, numTimeBuckets> timeCounts {};
+        std::array<juce::uint64, numLoadBuckets> loadCounts {};
+        juce::uint64 numBlocks = 0;
+        double totalSeconds = 0.0, maxSeconds = 0.0, maxLoad = 0.0;
+        std::array<CallStats, numCalls> calls {};
+
+        const CallStats& getCall (Call call) const noexcept  { return calls[(size_t) call]; }
+
+        /** Time per block at the given percentile (0..100), in seconds. */
+        double getTimePercentile (double percentile) const noexcept;
+
+        /** Share of the deadline used at the given percentile, 1.0 == 100 %. */
+        double getLoadPercentile (double percentile) const noexcept;
+
+        double getMeanSeconds() const noexcept  { return numBlocks > 0 ? totalSeconds / (double) numBlocks : 0.0; }
+
+        /** The block statistics and host call timings. */
+        juce::String toJson() const;
+
+        /** The two histograms. */
+        juce::String toCsv() const;
+    };
+
+    /** Any thread: copies the current statistics. */
+    Snapshot getSnapshot() const noexcept;
+
+    /** Asks for the block statistics to be cleared. The audio thread does it
+        at the start of the next block it records, so it stays their only
+        writer; until then, snapshots still show the old statistics. The host
+        call timings are kept, as some of those calls only happen once.
+        Safe to call from any thread.
+    */
+    void reset() noexcept;
+
+    /** Writes a snapshot to <file>.json and <file>.csv.
+        Returns false if either file couldn't be written.
+    */
+    bool exportTo (const juce::File& fileWithoutExtension) const;
+
+    /** Lower edge of a time bucket, in seconds. */
+    static double getTimeBucketStart (int bucket) noexcept;
+
+    /** Lower edge of a load bucket, 1.0 == 100 %. */
+    static double getLoadBucketStart (int bucket) noexcept;
+
+private:
+    //==============================================================================
+    static int getTimeBucket (double seconds) noexcept;
+    static int getLoadBucket (double load) noexcept;
+
+    template <typename Type>
+    static void increment (std::atomic<Type>& value, Type amount) noexcept
+    {
+        // Single writer, so a plain load/store pair is enough and avoids a locked RMW
+        value.store (value.load (std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<juce::uint64>, numTimeBuckets> timeCounts {};
+    std::array<std::atomic<juce::uint64>, numLoadBuckets> loadCounts {};
+    std::atomic<double> totalSeconds { 0.0 }, maxSeconds { 0.0 }, maxLoad { 0.0 };
+    std::atomic<bool> resetRequested { false };
+
+    struct CallCounters
+    {
+        std::atomic<juce::uint64> count { 0 };
+        std::atomic<double> lastSeconds { 0.0 }, maxSeconds { 0.0 }, totalSeconds { 0.0 };
+    };
+
+    std::array<CallCounters, numCalls> calls;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CpuTelemetry)
+};
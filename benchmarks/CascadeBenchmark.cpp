@@ -0,0 +1,271 @@
+/*
+    Runtime and noise of the steep cut designer, CascadeDesigner.
+
+    For each case it prints:
+    - the design time, the median of several designs of the same spec;
+    - the wait from CascadeDesignService::request() to the design being
+      published for the audio thread, with the designer thread asleep when
+      the request arrives, the median of several requests of new specs;
+    - the SNR of the cascade run in float on white noise at 0.5 peak, with
+      every section as transposed direct form II and as error feedback (what
+      the engine runs), against the same cascade in double;
+    - the internal peak: the largest sample between two sections in double,
+      relative to the input's peak, or - for a single section.
+
+    With no arguments it measures the cases the designer was written for;
+    any number of cases can be given instead, as family:type:order:frequency:sampleRate,
+    e.g.
+
+        IIRCascadeBenchmark butterworth:hp:24:30:48000 elliptic:lp:12:100:96000
+
+    where family is butterworth, chebyshev or elliptic and type is lp or hp.
+*/
+
+#include <JuceHeader.h>
+#include "DSP/CascadeDesignService.h"
+#include "DSP/SectionKernels.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace iir;
+
+namespace
+{
+    constexpr int lanes = 4;
+    constexpr int numFrames = 1 << 16;
+    constexpr int numDesigns = 21, numRequests = 21;
+    constexpr int labelWidth = 36;
+
+    const char* const familyNames[] = { "butterworth", "chebyshev", "elliptic" };
+
+    using Clock = std::chrono::steady_clock;
+
+    double microsecondsSince (Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::micro> (Clock::now() - start).count();
+    }
+
+    double median (std::vector<double> values)
+    {
+        std::sort (values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    bool parseCase (const std::string& text, CascadeSpec& result)
+    {
+        std::array<std::string, 5> fields;
+        size_t field = 0, start = 0;
+
+        for (size_t i = 0; i <= text.size() && field < fields.size(); ++i)
+        {
+            if (i == text.size() || text[i] == ':')
+            {
+                fields[field++] = text.substr (start, i - start);
+                start = i + 1;
+            }
+        }
+
+        if (field != fields.size() || (fields[1] != "lp" && fields[1] != "hp"))
+            return false;
+
+        for (int family = 0; family < numPrototypeFamilies; ++family)
+        {
+            if (fields[0] == familyNames[family])
+            {
+                result.family = (PrototypeFamily) family;
+                result.highPass = fields[1] == "hp";
+                result.order = std::stoi (fields[2]);
+                result.frequency = std::stod (fields[3]);
+                result.sampleRate = std::stod (fields[4]);
+                return result.order >= 1 && result.order <= maxCutOrder
+                    && result.frequency > 0.0 && result.frequency < result.sampleRate * 0.5;
+            }
+        }
+
+        return false;
+    }
+
+    CascadeSpec makeCase (PrototypeFamily family, bool highPass, int order, double frequency, double sampleRate)
+    {
+        CascadeSpec spec;
+        spec.family = family;
+        spec.highPass = highPass;
+        spec.order = order;
+        spec.frequency = frequency;
+        spec.sampleRate = sampleRate;
+        return spec;
+    }
+
+    double measureDesignTime (const CascadeSpec& spec)
+    {
+        std::vector<double> times;
+
+        for (int i = 0; i < numDesigns; ++i)
+        {
+            const auto start = Clock::now();
+            const auto design = CascadeDesigner::design (spec);
+            times.push_back (microsecondsSince (start));
+            juce::ignoreUnused (design);
+        }
+
+        return median (times);
+    }
+
+    /** Each request is for a frequency not asked for before, so it is designed
+        rather than found in a cache, and is made after a pause long enough for
+        the designer thread to have gone back to sleep.
+    */
+    double measureRequestTime (const CascadeSpec& spec)
+    {
+        CascadeDesignService service;
+        service.start();
+
+        std::vector<double> times;
+
+        for (int i = 0; i < numRequests; ++i)
+        {
+            auto request = spec;
+            request.frequency *= 1.0 + 1.0e-3 * (i + 1);
+
+            std::this_thread::sleep_for (std::chrono::milliseconds (2));
+
+            const auto start = Clock::now();
+            service.request (0, request);
+
+            for (;;)
+            {
+                const auto* design = service.acquire (0);
+
+                if (design != nullptr && design->spec == request)
+                    break;
+
+                std::this_thread::yield();
+            }
+
+            times.push_back (microsecondsSince (start));
+        }
+
+        return median (times);
+    }
+
+    template <typename SampleType>
+    void processCascade (const CascadeDesign& design, Topology topology, SampleType* data)
+    {
+        for (const auto& section : design.sections)
+        {
+            const auto coefficients = SectionCoefficients<SampleType>::fromBiquad (section, topology);
+            typename SectionKernels<SampleType, lanes>::State state;
+            SectionKernels<SampleType, lanes>::process (coefficients, state, data, numFrames);
+        }
+    }
+
+    double getInternalPeak (const CascadeDesign& design, const std::vector<float>& input)
+    {
+        std::vector<double> data (input.begin(), input.end());
+        auto peak = 0.0;
+
+        for (size_t n = 0; n + 1 < design.sections.size(); ++n)
+        {
+            const auto coefficients = SectionCoefficients<double>::fromBiquad (design.sections[n], Topology::transposedDirectForm2);
+            SectionKernels<double, lanes>::State state;
+            SectionKernels<double, lanes>::process (coefficients, state, data.data(), numFrames);
+
+            for (auto x : data)
+                peak = std::max (peak, std::abs (x));
+        }
+
+        return peak / 0.5;
+    }
+
+    double measureSnr (const CascadeDesign& design, Topology topology,
+                       const std::vector<float>& input, const std::vector<double>& reference)
+    {
+        auto output = input;
+        processCascade (design, topology, output.data());
+
+        // The first quarter is left out, so the start-up transient doesn't count
+        double signal = 0.0, noise = 0.0;
+
+        for (size_t i = output.size() / 4; i < output.size(); ++i)
+        {
+            signal += reference[i] * reference[i];
+            noise += juce::square ((double) output[i] - reference[i]);
+        }
+
+        return noise > 0.0 ? 10.0 * std::log10 (signal / noise) : 999.0;
+    }
+
+    void measure (const CascadeSpec& spec, const std::vector<float>& input)
+    {
+        const auto design = CascadeDesigner::design (spec);
+
+        std::vector<double> reference (input.begin(), input.end());
+        processCascade (design, Topology::transposedDirectForm2, reference.data());
+
+        char label[128];
+        std::snprintf (label, sizeof (label), "%s %s %d %g Hz @ %g", familyNames[(int) spec.family],
+                       spec.highPass ? "hp" : "lp", spec.order, spec.frequency, spec.sampleRate);
+
+        std::printf ("%-*s %10.1f %10.1f %8.0fdB %8.0fdB", labelWidth, label,
+                     measureDesignTime (spec), measureRequestTime (spec),
+                     measureSnr (design, Topology::transposedDirectForm2, input, reference),
+                     measureSnr (design, Topology::errorFeedback, input, reference));
+
+        if (design.sections.size() > 1)
+            std::printf (" %8.2f\n", getInternalPeak (design, input));
+        else
+            std::printf (" %8s\n", "-");
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    std::vector<CascadeSpec> cases;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        CascadeSpec spec;
+
+        if (! parseCase (argv[i], spec))
+        {
+            std::fprintf (stderr, "Can't read \"%s\"; expected family:lp|hp:order:frequency:sampleRate\n", argv[i]);
+            return 1;
+        }
+
+        cases.push_back (spec);
+    }
+
+    if (cases.empty())
+    {
+        cases.push_back (makeCase (PrototypeFamily::butterworth, true,  2,  30.0,    48000.0));
+        cases.push_back (makeCase (PrototypeFamily::butterworth, true,  8,  30.0,    48000.0));
+        cases.push_back (makeCase (PrototypeFamily::butterworth, true,  24, 30.0,    48000.0));
+        cases.push_back (makeCase (PrototypeFamily::chebyshev,   false, 8,  15000.0, 48000.0));
+        cases.push_back (makeCase (PrototypeFamily::elliptic,    false, 12, 100.0,   96000.0));
+        cases.push_back (makeCase (PrototypeFamily::elliptic,    false, 24, 20000.0, 96000.0));
+    }
+
+    std::vector<float> input ((size_t) (numFrames * lanes));
+    std::mt19937 random (1);
+    std::uniform_real_distribution<float> noise (-0.5f, 0.5f);
+
+    for (auto& x : input)
+        x = noise (random);
+
+    std::printf ("design and request times in us (medians), SNR against the cascade in double, %d lanes\n", lanes);
+    std::printf ("%-*s %10s %10s %10s %10s %8s\n", labelWidth, "", "design", "request", "TDF2", "ErrFb", "peak");
+
+    for (const auto& spec : cases)
+        measure (spec, input);
+
+    return 0;
+}
@@ -0,0 +1,292 @@
+/*
+    Cost and accuracy of a filter whose cutoff and Q move every sample: the
+    TPT state variable filter ModulationEngine runs, against a cookbook biquad
+    redesigned every sample and one redesigned every 32 samples, the usual
+    way around the cost.
+
+    Each case sweeps the cutoff with a sine over the given number of octaves
+    either side of its centre, at the given rate, and the Q over half as many
+    octaves at 1.3 times that rate, over two channels of white noise at 0.5
+    peak at 48 kHz. The time is per sample per channel, the best of several
+    runs, including the redesigns. The SNR is against the same sweep through
+    the state variable filter in double with an exact tan, the reference for a
+    filter whose coefficients move; the peak shows a path that has started
+    to ring up or blow up. With no arguments it measures the cases the
+    modulation engine was written for; any cases can be given instead, as
+    type:frequency:q:gainDb:octaves:rateHz, e.g.
+
+        IIRModulationBenchmark lp:1000:8:0:3:200
+
+    where type is one of lp, hp, bp, notch, bell, lowshelf or highshelf.
+*/
+
+#include <JuceHeader.h>
+#include "DSP/BiquadCoefficients.h"
+#include "DSP/StateVariableFilter.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace iir;
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+    constexpr int numSamples = 1 << 16;
+    constexpr int numRuns = 8;
+    constexpr int blockRedesignInterval = 32;
+    constexpr int labelWidth = 40;
+
+    const char* const typeNames[] = { "lp", "hp", "bp", "notch", "bell", "lowshelf", "highshelf" };
+
+    struct Case
+    {
+        BandSettings band;
+        float octaves = 2.0f, rateHz = 5.0f;
+    };
+
+    struct Sweep
+    {
+        std::vector<float> frequencies, qs;
+    };
+
+    bool parseCase (const std::string& text, Case& result)
+    {
+        std::array<std::string, 6> fields;
+        size_t field = 0, start = 0;
+
+        for (size_t i = 0; i <= text.size() && field < fields.size(); ++i)
+        {
+            if (i == text.size() || text[i] == ':')
+            {
+                fields[field++] = text.substr (start, i - start);
+                start = i + 1;
+            }
+        }
+
+        if (field != fields.size())
+            return false;
+
+        for (int type = 0; type < numFilterTypes; ++type)
+        {
+            if (fields[0] == typeNames[type])
+            {
+                result.band.enabled = true;
+                result.band.type = (FilterType) type;
+                result.band.frequency = std::stof (fields[1]);
+                result.band.q = std::stof (fields[2]);
+                result.band.gainDb = std::stof (fields[3]);
+                result.octaves = std::stof (fields[4]);
+                result.rateHz = std::stof (fields[5]);
+                return result.band.frequency > 0.0f && result.band.q > 0.0f && result.rateHz >= 0.0f;
+            }
+        }
+
+        return false;
+    }
+
+    Case makeCase (FilterType type, float frequency, float q, float gainDb, float octaves, float rateHz)
+    {
+        Case c;
+        c.band.enabled = true;
+        c.band.type = type;
+        c.band.frequency = frequency;
+        c.band.q = q;
+        c.band.gainDb = gainDb;
+        c.octaves = octaves;
+        c.rateHz = rateHz;
+        return c;
+    }
+
+    Sweep makeSweep (const Case& c)
+    {
+        Sweep sweep;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto phase = juce::MathConstants<double>::twoPi * c.rateHz * i / sampleRate;
+            sweep.frequencies.push_back ((float) (c.band.frequency * std::exp2 (c.octaves * std::sin (phase))));
+            sweep.qs.push_back ((float) (c.band.q * std::exp2 (0.5 * c.octaves * std::sin (1.3 * phase))));
+        }
+
+        return sweep;
+    }
+
+    //==============================================================================
+    /** The state variable filter in double, redesigned every sample with an exact tan. */
+    std::vector<double> getReference (const Case& c, const Sweep& sweep, const std::vector<float>& input)
+    {
+        const auto prototype = SvfCoefficients<double>::Prototype::make (c.band.type, c.band.gainDb, sampleRate);
+        std::array<SvfState<double>, numChannels> states;
+        std::vector<double> output (input.size());
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // The same design, with std::tan in place of FastMath's
+            auto design = SvfCoefficients<double>::design (prototype, sweep.frequencies[(size_t) i], sweep.qs[(size_t) i]);
+            const auto frequency = juce::jlimit (1.0, prototype.maxFrequency, (double) sweep.frequencies[(size_t) i]);
+            auto g = std::tan (frequency * prototype.piOverSampleRate);
+
+            if (c.band.type == FilterType::lowShelf)   g /= prototype.sqrtA;
+            if (c.band.type == FilterType::highShelf)  g *= prototype.sqrtA;
+
+            design.a1 = 1.0 / (1.0 + g * (g + design.k));
+            design.a2 = g * design.a1;
+            design.a3 = g * design.a2;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto index = (size_t) (i * numChannels + ch);
+                output[index] = states[(size_t) ch].processSample (design, (double) input[index]);
+            }
+        }
+
+        return output;
+    }
+
+    /** Runs the sweep through the TPT SVF, redesigned every sample as ModulationEngine does. */
+    void processSvf (const Case& c, const Sweep& sweep, float* data)
+    {
+        const auto prototype = SvfCoefficients<float>::Prototype::make (c.band.type, c.band.gainDb, sampleRate);
+        std::array<SvfState<float>, numChannels> states;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto design = SvfCoefficients<float>::design (prototype, sweep.frequencies[(size_t) i], sweep.qs[(size_t) i]);
+            auto* frame = data + i * numChannels;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                frame[ch] = states[(size_t) ch].processSample (design, frame[ch]);
+        }
+    }
+
+    /** Runs the sweep through a transposed direct form II biquad redesigned every interval samples. */
+    void processBiquad (const Case& c, const Sweep& sweep, float* data, int interval)
+    {
+        auto band = c.band;
+        BiquadCoefficients<float> design;
+        std::array<float, numChannels> z1 {}, z2 {};
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (i % interval == 0)
+            {
+                band.frequency = sweep.frequencies[(size_t) i];
+                band.q = sweep.qs[(size_t) i];
+                design = BiquadCoefficients<float>::design (band, sampleRate);
+            }
+
+            auto* frame = data + i * numChannels;
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                const auto x = frame[ch];
+                const auto y = design.b0 * x + z1[ch];
+                z1[ch] = design.b1 * x - design.a1 * y + z2[ch];
+                z2[ch] = design.b2 * x - design.a2 * y;
+                frame[ch] = y;
+            }
+        }
+    }
+
+    //==============================================================================
+    template <typename Process>
+    void measure (const std::vector<float>& input, const std::vector<double>& reference, Process&& process)
+    {
+        std::vector<float> output;
+        auto best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            output = input;
+
+            const auto start = std::chrono::steady_clock::now();
+            process (output.data());
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            best = juce::jmin (best, elapsed.count() / (double) (numSamples * numChannels));
+        }
+
+        double signal = 0.0, noise = 0.0, peak = 0.0;
+
+        for (size_t i = 0; i < output.size(); ++i)
+        {
+            signal += reference[i] * reference[i];
+            noise += juce::square ((double) output[i] - reference[i]);
+            peak = juce::jmax (peak, (double) std::abs (output[i]));
+        }
+
+        const auto snr = noise > 0.0 ? 10.0 * std::log10 (signal / noise) : 999.0;
+        const auto peakDb = std::isfinite (peak) && peak > 0.0 ? 20.0 * std::log10 (peak) : 999.0;
+        std::printf ("  %4.1f/%4.0fdB/%+4.0fdB", best, snr, peakDb);
+    }
+
+    void measure (const Case& c, const std::vector<float>& input)
+    {
+        const auto sweep = makeSweep (c);
+        const auto reference = getReference (c, sweep, input);
+
+        char label[128];
+        std::snprintf (label, sizeof (label), "%s %g Hz Q %g %+g dB, %g oct @ %g Hz", typeNames[(int) c.band.type],
+                       (double) c.band.frequency, (double) c.band.q, (double) c.band.gainDb,
+                       (double) c.octaves, (double) c.rateHz);
+        std::printf ("%-*s", labelWidth, label);
+
+        measure (input, reference, [&] (float* data) { processSvf (c, sweep, data); });
+        measure (input, reference, [&] (float* data) { processBiquad (c, sweep, data, 1); });
+        measure (input, reference, [&] (float* data) { processBiquad (c, sweep, data, blockRedesignInterval); });
+
+        std::printf ("\n");
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    std::vector<Case> cases;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        Case c;
+
+        if (! parseCase (argv[i], c))
+        {
+            std::fprintf (stderr, "Can't read \"%s\"; expected type:frequency:q:gainDb:octaves:rateHz\n", argv[i]);
+            return 1;
+        }
+
+        cases.push_back (c);
+    }
+
+    if (cases.empty())
+    {
+        cases.push_back (makeCase (FilterType::lowPass,  1000.0f, 0.707f, 0.0f,  2.0f, 5.0f));
+        cases.push_back (makeCase (FilterType::lowPass,  1000.0f, 8.0f,   0.0f,  3.0f, 200.0f));
+        cases.push_back (makeCase (FilterType::bandPass, 2000.0f, 4.0f,   0.0f,  2.0f, 1000.0f));
+        cases.push_back (makeCase (FilterType::peak,     1000.0f, 4.0f,   12.0f, 2.0f, 1000.0f));
+        cases.push_back (makeCase (FilterType::lowPass,  300.0f,  20.0f,  0.0f,  4.0f, 2000.0f));
+    }
+
+    std::vector<float> input ((size_t) (numSamples * numChannels));
+    std::mt19937 random (1);
+    std::uniform_real_distribution<float> noise (-0.5f, 0.5f);
+
+    for (auto& x : input)
+        x = noise (random);
+
+    std::printf ("ns per sample per channel / SNR against the swept SVF in double / peak, %d channels\n%-*s",
+                 numChannels, labelWidth, "");
+    std::printf ("  %-20s  %-20s  %-20s\n", "TPT SVF", "biquad, every sample", "biquad, every 32");
+
+    for (const auto& c : cases)
+        measure (c, input);
+
+    return 0;
+}
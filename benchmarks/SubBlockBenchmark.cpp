@@ -0,0 +1,147 @@
+/*
+    The engine's speed for each sub-block length, the sweep that picked
+    FilterEngine::defaultSubBlockSize.
+
+    Eight transposed direct form II bells and an 8th-order low and high cut
+    run over host blocks of 2048 frames of noise at 48 kHz, on the audio
+    thread alone, for 2, 8 and 32 channels. The time is per sample per
+    channel, the best of several runs. With no arguments it tries every
+    length from 32 to 256 that FilterEngine accepts in steps of 32; any
+    lengths can be given instead, e.g.
+
+        IIRSubBlockBenchmark 64 128 256
+
+    The best length found for a machine can be set without a rebuild with
+    the IIRFILTERS_SUB_BLOCK_SIZE environment variable.
+*/
+
+#include <JuceHeader.h>
+#include "DSP/FilterEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace iir;
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int hostBlockSize = 2048;
+    constexpr int numWarmUpBlocks = 20, numRuns = 60, numBlocksPerRun = 10;
+    constexpr int channelCounts[] = { 2, 8, 32 };
+
+    double measure (int subBlockSize, int numChannels)
+    {
+        FilterEngine engine;
+        engine.setMaxNumWorkers (0);
+        engine.prepare (sampleRate, hostBlockSize, numChannels);
+        engine.setSubBlockSize (subBlockSize);
+
+        FilterSettings settings;
+
+        for (int band = 0; band < maxBands; ++band)
+        {
+            auto& b = settings.bands[(size_t) band];
+            b.enabled = true;
+            b.type = FilterType::peak;
+            b.frequency = 100.0f * (float) (band + 1);
+            b.gainDb = 3.0f;
+            b.topology = Topology::transposedDirectForm2;
+        }
+
+        engine.setSettings (settings);
+
+        CascadeSpec spec;
+        spec.order = 8;
+        spec.sampleRate = sampleRate;
+        spec.highPass = true;
+        spec.frequency = 40.0;
+        const auto lowCutDesign = CascadeDesigner::design (spec);
+
+        spec.highPass = false;
+        spec.frequency = 15000.0;
+        const auto highCutDesign = CascadeDesigner::design (spec);
+
+        engine.setCascade (lowCut, &lowCutDesign);
+        engine.setCascade (highCut, &highCutDesign);
+
+        std::mt19937 random (1);
+        std::uniform_real_distribution<float> noise (-0.3f, 0.3f);
+        std::vector<std::vector<float>> buffers ((size_t) numChannels, std::vector<float> ((size_t) hostBlockSize));
+        std::vector<float*> channels;
+
+        for (auto& buffer : buffers)
+        {
+            for (auto& sample : buffer)
+                sample = noise (random);
+
+            channels.push_back (buffer.data());
+        }
+
+        for (int block = 0; block < numWarmUpBlocks; ++block)
+            engine.process (channels.data(), numChannels, hostBlockSize);
+
+        auto best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int block = 0; block < numBlocksPerRun; ++block)
+                engine.process (channels.data(), numChannels, hostBlockSize);
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min (best, elapsed.count() / ((double) numBlocksPerRun * hostBlockSize * numChannels));
+        }
+
+        return best;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    std::vector<int> subBlockSizes;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const auto size = std::atoi (argv[i]);
+
+        if (size < FilterEngine::minSubBlockSize || size > FilterEngine::maxSubBlockSize)
+        {
+            std::fprintf (stderr, "Can't use \"%s\"; sub-blocks are %d to %d frames\n",
+                          argv[i], FilterEngine::minSubBlockSize, FilterEngine::maxSubBlockSize);
+            return 1;
+        }
+
+        subBlockSizes.push_back (size);
+    }
+
+    if (subBlockSizes.empty())
+        for (int size = FilterEngine::minSubBlockSize; size <= FilterEngine::maxSubBlockSize; size += 32)
+            subBlockSizes.push_back (size);
+
+    std::printf ("ns per sample per channel, host blocks of %d frames\n%-10s", hostBlockSize, "sub-block");
+
+    for (auto numChannels : channelCounts)
+        std::printf ("  %8d ch", numChannels);
+
+    std::printf ("\n");
+
+    for (auto size : subBlockSizes)
+    {
+        std::printf ("%-10d", size);
+
+        for (auto numChannels : channelCounts)
+            std::printf ("  %11.2f", measure (size, numChannels));
+
+        std::printf ("%s\n", size == FilterEngine::defaultSubBlockSize ? "  (default)" : "");
+    }
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*
+    Speed and accuracy of each band topology's float kernel, for one section
+    running over four lanes of white noise with the baseline instruction set.
+
+    The SNR is against a transposed direct form II run in double precision;
+    the time is per sample per channel, the best of several runs. With no
+    arguments it measures the cases the topologies were chosen on; any
+    number of cases can be given instead, as type:frequency:q:gainDb:sampleRate,
+    e.g.
+
+        IIRTopologyBenchmark lp:20:0.707:0:96000 bell:30:8:12:192000
+
+    where type is one of lp, hp, bp, notch, bell, lowshelf or highshelf.
+*/
+
+#include <JuceHeader.h>
+#include "DSP/SectionKernels.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+using namespace iir;
+
+namespace
+{
+    constexpr int lanes = 4;
+    constexpr int numFrames = 1 << 16;
+    constexpr int numRuns = 8;
+    constexpr int labelWidth = 40;
+
+    const char* const typeNames[]     = { "lp", "hp", "bp", "notch", "bell", "lowshelf", "highshelf" };
+    const char* const topologyNames[] = { "DF1", "TDF2", "SVF", "Lattice", "Coupled", "ErrFb" };
+
+    struct Case
+    {
+        BandSettings band;
+        double sampleRate = 48000.0;
+    };
+
+    bool parseCase (const std::string& text, Case& result)
+    {
+        std::array<std::string, 5> fields;
+        size_t field = 0, start = 0;
+
+        for (size_t i = 0; i <= text.size() && field < fields.size(); ++i)
+        {
+            if (i == text.size() || text[i] == ':')
+            {
+                fields[field++] = text.substr (start, i - start);
+                start = i + 1;
+            }
+        }
+
+        if (field != fields.size())
+            return false;
+
+        for (int type = 0; type < numFilterTypes; ++type)
+        {
+            if (fields[0] == typeNames[type])
+            {
+                result.band.enabled = true;
+                result.band.type = (FilterType) type;
+                result.band.frequency = std::stof (fields[1]);
+                result.band.q = std::stof (fields[2]);
+                result.band.gainDb = std::stof (fields[3]);
+                result.sampleRate = std::stod (fields[4]);
+                return result.band.frequency > 0.0f && result.band.q > 0.0f && result.sampleRate > 0.0;
+            }
+        }
+
+        return false;
+    }
+
+    Case makeCase (FilterType type, float frequency, float q, float gainDb, double sampleRate)
+    {
+        Case c;
+        c.band.enabled = true;
+        c.band.type = type;
+        c.band.frequency = frequency;
+        c.band.q = q;
+        c.band.gainDb = gainDb;
+        c.sampleRate = sampleRate;
+        return c;
+    }
+
+    void measure (const Case& c, const std::vector<float>& input)
+    {
+        // The reference, in double
+        auto referenceBand = c.band;
+        referenceBand.topology = Topology::transposedDirectForm2;
+        const auto referenceCoefficients = SectionCoefficients<double>::design (referenceBand, c.sampleRate);
+
+        std::vector<double> reference (input.begin(), input.end());
+        SectionKernels<double, lanes>::State referenceState;
+        SectionKernels<double, lanes>::process (referenceCoefficients, referenceState, reference.data(), numFrames);
+
+        char label[128];
+        std::snprintf (label, sizeof (label), "%s %g Hz Q %g %+g dB @ %g", typeNames[(int) c.band.type],
+                       (double) c.band.frequency, (double) c.band.q, (double) c.band.gainDb, c.sampleRate);
+        std::printf ("%-*s", labelWidth, label);
+
+        for (int topology = 0; topology < numTopologies; ++topology)
+        {
+            auto band = c.band;
+            band.topology = (Topology) topology;
+            const auto coefficients = SectionCoefficients<float>::design (band, c.sampleRate);
+
+            std::vector<float> output;
+            auto best = std::numeric_limits<double>::max();
+
+            for (int run = 0; run < numRuns; ++run)
+            {
+                output = input;
+                SectionKernels<float, lanes>::State state;
+
+                const auto start = std::chrono::steady_clock::now();
+                SectionKernels<float, lanes>::process (coefficients, state, output.data(), numFrames);
+                const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+                best = juce::jmin (best, elapsed.count() / (double) (numFrames * lanes));
+            }
+
+            // The first quarter is left out, so the start-up transient doesn't count
+            double signal = 0.0, noise = 0.0;
+
+            for (size_t i = output.size() / 4; i < output.size(); ++i)
+            {
+                signal += reference[i] * reference[i];
+                noise += juce::square ((double) output[i] - reference[i]);
+            }
+
+            const auto snr = noise > 0.0 ? 10.0 * std::log10 (signal / noise) : 999.0;
+            std::printf ("  %4.1f/%4.0fdB", best, snr);
+        }
+
+        std::printf ("\n");
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    std::vector<Case> cases;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        Case c;
+
+        if (! parseCase (argv[i], c))
+        {
+            std::fprintf (stderr, "Can't read \"%s\"; expected type:frequency:q:gainDb:sampleRate\n", argv[i]);
+            return 1;
+        }
+
+        cases.push_back (c);
+    }
+
+    if (cases.empty())
+    {
+        cases.push_back (makeCase (FilterType::lowPass,  20.0f,   0.707f, 0.0f,  96000.0));
+        cases.push_back (makeCase (FilterType::lowPass,  20.0f,   10.0f,  0.0f,  192000.0));
+        cases.push_back (makeCase (FilterType::peak,     30.0f,   8.0f,   12.0f, 192000.0));
+        cases.push_back (makeCase (FilterType::highPass, 40.0f,   2.0f,   0.0f,  96000.0));
+        cases.push_back (makeCase (FilterType::lowPass,  1000.0f, 0.707f, 0.0f,  48000.0));
+    }
+
+    std::vector<float> input ((size_t) (numFrames * lanes));
+    std::mt19937 random (1);
+    std::uniform_real_distribution<float> noise (-0.5f, 0.5f);
+
+    for (auto& x : input)
+        x = noise (random);
+
+    std::printf ("ns per sample per channel / SNR against double TDF2, %d lanes\n%-*s", lanes, labelWidth, "");
+
+    for (auto* name : topologyNames)
+        std::printf ("  %-11s", name);
+
+    std::printf ("\n");
+
+    for (const auto& c : cases)
+        measure (c, input);
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+    How much the engine's worker threads speed up a multi-channel block.
+
+    Eight transposed direct form II bells and an 8th-order low and high cut
+    run over host blocks of 512 frames of noise at 48 kHz, for 32, 64 and 128
+    channels, with the audio thread alone and then with up to 1, 2 and 3
+    workers. The time is per sample per channel, the best of several runs,
+    and the speed-up is against the audio thread alone. FilterEngine starts
+    no more workers than there are spare cores or lane groups, so the
+    "workers" column says how many actually ran. The maximum can be given
+    instead, e.g.
+
+        IIRWorkerBenchmark 7
+*/
+
+#include <JuceHeader.h>
+#include "DSP/FilterEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace iir;
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int hostBlockSize = 512;
+    constexpr int numWarmUpBlocks = 50, numRuns = 40, numBlocksPerRun = 20;
+    constexpr int channelCounts[] = { 32, 64, 128 };
+
+    struct Result
+    {
+        double nanoseconds = 0.0;
+        int numWorkers = 0;
+    };
+
+    Result measure (int maxNumWorkers, int numChannels)
+    {
+        FilterEngine engine;
+        engine.setMaxNumWorkers (maxNumWorkers);
+        engine.prepare (sampleRate, hostBlockSize, numChannels);
+
+        FilterSettings settings;
+
+        for (int band = 0; band < maxBands; ++band)
+        {
+            auto& b = settings.bands[(size_t) band];
+            b.enabled = true;
+            b.type = FilterType::peak;
+            b.frequency = 100.0f * (float) (band + 1);
+            b.gainDb = 3.0f;
+            b.topology = Topology::transposedDirectForm2;
+        }
+
+        engine.setSettings (settings);
+
+        CascadeSpec spec;
+        spec.order = 8;
+        spec.sampleRate = sampleRate;
+        spec.highPass = true;
+        spec.frequency = 40.0;
+        const auto lowCutDesign = CascadeDesigner::design (spec);
+
+        spec.highPass = false;
+        spec.frequency = 15000.0;
+        const auto highCutDesign = CascadeDesigner::design (spec);
+
+        engine.setCascade (lowCut, &lowCutDesign);
+        engine.setCascade (highCut, &highCutDesign);
+
+        std::mt19937 random (1);
+        std::uniform_real_distribution<float> noise (-0.3f, 0.3f);
+        std::vector<std::vector<float>> buffers ((size_t) numChannels, std::vector<float> ((size_t) hostBlockSize));
+        std::vector<float*> channels;
+
+        for (auto& buffer : buffers)
+        {
+            for (auto& sample : buffer)
+                sample = noise (random);
+
+            channels.push_back (buffer.data());
+        }
+
+        for (int block = 0; block < numWarmUpBlocks; ++block)
+            engine.process (channels.data(), numChannels, hostBlockSize);
+
+        auto best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int block = 0; block < numBlocksPerRun; ++block)
+                engine.process (channels.data(), numChannels, hostBlockSize);
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min (best, elapsed.count() / ((double) numBlocksPerRun * hostBlockSize * numChannels));
+        }
+
+        return { best, engine.getNumWorkers() };
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const auto maxNumWorkers = argc > 1 ? std::atoi (argv[1]) : FilterEngine::defaultMaxNumWorkers;
+
+    if (maxNumWorkers < 0)
+    {
+        std::fprintf (stderr, "usage: %s [maximum number of workers]\n", argv[0]);
+        return 1;
+    }
+
+    std::printf ("ns per sample per channel, host blocks of %d frames, %d cores\n\n",
+                 hostBlockSize, juce::SystemStats::getNumCpus());
+    std::printf ("%-10s %-10s %10s %10s %10s\n", "channels", "at most", "workers", "ns", "speed-up");
+
+    for (auto numChannels : channelCounts)
+    {
+        const auto alone = measure (0, numChannels);
+        std::printf ("%-10d %-10d %10d %10.2f %9.2fx\n", numChannels, 0, alone.numWorkers, alone.nanoseconds, 1.0);
+
+        for (int workers = 1; workers <= maxNumWorkers; ++workers)
+        {
+            const auto result = measure (workers, numChannels);
+            std::printf ("%-10s %-10d %10d %10.2f %9.2fx\n", "", workers, result.numWorkers,
+                         result.nanoseconds, alone.nanoseconds / result.nanoseconds);
+        }
+    }
+
+    return 0;
+}
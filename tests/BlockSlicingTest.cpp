@@ -0,0 +1,181 @@
+/*
+    Runs the processor over the same two seconds of noise cut into blocks of
+    every awkward size a host can send, and checks the output against one
+    block covering the whole signal.
+
+    Every filter the engine runs carries its state across blocks and the
+    modulation and dynamics advance per sample, so the output must not depend
+    on where the blocks are cut. The patterns are blocks of one sample, of
+    cycling primes, of random sizes from 1 to 4096, and blocks eight times the
+    size given to prepareToPlay. It also prints the longest single call, to
+    catch a pattern that makes one block much more expensive than the rest.
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numSamples = 2 * 48000;
+
+    // The engine and modulation run the same arithmetic on the same samples
+    // whatever the block size, so any difference at all is a bug; the margin
+    // only leaves room for a compiler contracting differently across inlined copies
+    constexpr float tolerance = 1.0e-6f;
+
+    using BlockSizes = std::function<int (int)>;
+
+    struct Pattern
+    {
+        const char* name;
+        int preparedBlockSize;
+        BlockSizes nextBlockSize;
+    };
+
+    struct Run
+    {
+        juce::AudioBuffer<float> output;
+        double longestCall = 0.0, longestPerSample = 0.0, totalSeconds = 0.0;
+        int numCalls = 0;
+    };
+
+    void setParameter (AudioPluginAudioProcessor& processor, int index, float value)
+    {
+        auto* parameter = processor.getParameters().getParameter (Parameters::getId (index));
+        jassert (parameter != nullptr);
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+
+    /** Every band on, each with a different type and topology, one of them
+        dynamic, with the modulated band and both cuts running. The cuts stay
+        at their default frequencies, which have precomputed designs, so
+        nothing waits on the background designer.
+    */
+    void configure (AudioPluginAudioProcessor& processor)
+    {
+        using namespace Parameters;
+
+        for (int band = 0; band < iir::maxBands; ++band)
+        {
+            setParameter (processor, indexOf (band, BandField::enabled), 1.0f);
+            setParameter (processor, indexOf (band, BandField::type), (float) (band % iir::numFilterTypes));
+            setParameter (processor, indexOf (band, BandField::frequency), 100.0f * (float) (band + 1));
+            setParameter (processor, indexOf (band, BandField::gain), 3.0f);
+            setParameter (processor, indexOf (band, BandField::topology), (float) (band % iir::numTopologies));
+        }
+
+        setParameter (processor, indexOf (4, BandField::type), (float) iir::FilterType::peak);
+        setParameter (processor, indexOf (4, DynamicsField::enabled), 1.0f);
+        setParameter (processor, indexOf (4, DynamicsField::threshold), -30.0f);
+
+        setParameter (processor, indexOf (ModulationField::enabled), 1.0f);
+        setParameter (processor, indexOf (ModulationField::lfoToCutoff), 2.0f);
+        setParameter (processor, indexOf (ModulationField::envelopeToCutoff), 1.0f);
+
+        setParameter (processor, indexOf (iir::lowCut, CutField::enabled), 1.0f);
+        setParameter (processor, indexOf (iir::highCut, CutField::enabled), 1.0f);
+    }
+
+    Run process (const juce::AudioBuffer<float>& input, int preparedBlockSize, const BlockSizes& nextBlockSize)
+    {
+        AudioPluginAudioProcessor processor;
+        configure (processor);
+
+        processor.setRateAndBufferSizeDetails (sampleRate, preparedBlockSize);
+        processor.prepareToPlay (sampleRate, preparedBlockSize);
+
+        const auto numChannels = juce::jmax (processor.getTotalNumInputChannels(),
+                                             processor.getTotalNumOutputChannels());
+
+        Run run;
+        run.output.setSize (numChannels, numSamples);
+        run.output.clear();
+
+        for (int channel = 0; channel < juce::jmin (numChannels, input.getNumChannels()); ++channel)
+            run.output.copyFrom (channel, 0, input, channel, 0, numSamples);
+
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < numSamples;)
+        {
+            const auto blockSize = juce::jmin (nextBlockSize (run.numCalls), numSamples - start);
+            juce::AudioBuffer<float> block (run.output.getArrayOfWritePointers(), numChannels, start, blockSize);
+
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            processor.processBlock (block, midi);
+            const auto seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+            run.longestCall = juce::jmax (run.longestCall, seconds);
+            run.longestPerSample = juce::jmax (run.longestPerSample, seconds / blockSize);
+            run.totalSeconds += seconds;
+            ++run.numCalls;
+            start += blockSize;
+        }
+
+        processor.releaseResources();
+        return run;
+    }
+
+    float maxDifference (const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        auto result = 0.0f;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                result = juce::jmax (result, std::abs (a.getSample (channel, i) - b.getSample (channel, i)));
+
+        return result;
+    }
+}
+
+int main()
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::AudioBuffer<float> input (2, numSamples);
+    juce::Random random (1);
+
+    for (int channel = 0; channel < input.getNumChannels(); ++channel)
+        for (int i = 0; i < numSamples; ++i)
+            input.setSample (channel, i, random.nextFloat() - 0.5f);
+
+    const auto reference = process (input, numSamples, [] (int) { return numSamples; });
+
+    static constexpr int primes[] = { 3, 7, 31, 61, 127, 251, 509, 1021, 2039, 4093 };
+    juce::Random sizes (2);
+
+    const Pattern patterns[] =
+    {
+        { "blocks of 1",         4096, [] (int) { return 1; } },
+        { "primes 3 to 4093",    4096, [] (int call) { return primes[call % juce::numElementsInArray (primes)]; } },
+        { "random 1 to 4096",    4096, [&sizes] (int) { return 1 + sizes.nextInt (4096); } },
+        { "4096, prepared 512",   512, [] (int) { return 4096; } }
+    };
+
+    std::printf ("tolerance %g, reference one block of %d samples at %g Hz\n\n", (double) tolerance, numSamples, sampleRate);
+    std::printf ("%-20s %8s %12s %14s %16s %12s\n", "pattern", "calls", "max diff", "longest (us)", "worst (ns/smp)", "mean (ns/smp)");
+
+    auto failed = false;
+
+    for (const auto& pattern : patterns)
+    {
+        const auto run = process (input, pattern.preparedBlockSize, pattern.nextBlockSize);
+        const auto difference = maxDifference (run.output, reference.output);
+        const auto passed = difference <= tolerance;
+
+        std::printf ("%-20s %8d %12g %14.1f %16.1f %12.1f  %s\n",
+                     pattern.name, run.numCalls, (double) difference,
+                     run.longestCall * 1.0e6, run.longestPerSample * 1.0e9,
+                     run.totalSeconds * 1.0e9 / numSamples,
+                     passed ? "ok" : "FAILED");
+
+        failed = failed || ! passed;
+    }
+
+    return failed ? 1 : 0;
+}
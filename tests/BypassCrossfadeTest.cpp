@@ -0,0 +1,187 @@
+/*
+    Drives iir::BypassCrossfade with a latency, which the plug-in itself
+    doesn't have yet, so the dry delay line is covered before anything relies
+    on it.
+
+    A stand-in for the processed path delays the input by the same latency and
+    scales it by a known gain. With that gain at 1 every output sample must be
+    exactly the input from latency samples earlier, whether bypassed, fully
+    processed or halfway through a fade: the dry and processed paths have to
+    line up or a fade jumps in time. With a gain of 2 the output over the
+    input's delayed copy reads back the processed path's weight, which has to
+    move between 1 and 0 in steps of one over the fade's length, from
+    wherever it had got to when the bypass switched. Every case runs in
+    blocks of cycling primes, so blocks start at every offset into the delay
+    line, and for latencies from 0 to longer than a block.
+*/
+
+#include <JuceHeader.h>
+#include "DSP/BypassCrossfade.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace iir;
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int maxBlockSize = 509;
+    constexpr int numChannels = 2;
+    constexpr int numSamples = 48000;
+    constexpr float tolerance = 1.0e-6f;
+
+    constexpr int latencies[] = { 0, 1, 37, 256, 1021 };
+    constexpr int primes[] = { 3, 7, 31, 61, 127, 251, 509 };
+
+    // Bypass switches on and off at these samples
+    constexpr int switches[] = { 4000, 12000, 12100, 30000 };
+
+    float getInput (int channel, int i)
+    {
+        return std::sin (0.001f * (float) i * (float) (channel + 1)) + 0.001f * (float) (i % 97);
+    }
+
+    float getDelayedInput (int channel, int i, int latency)
+    {
+        return i >= latency ? getInput (channel, i - latency) : 0.0f;
+    }
+
+    bool isBypassedAt (int i)
+    {
+        auto bypassed = false;
+
+        for (auto s : switches)
+            if (i >= s)
+                bypassed = ! bypassed;
+
+        return bypassed;
+    }
+
+    struct Run
+    {
+        std::vector<float> output;      // the first channel
+        std::vector<double> expected;   // the processed path's weight, fading a step per sample
+    };
+
+    /** Runs the signal through the crossfade in blocks of cycling primes, with
+        the processed path as the input delayed by the latency times wetGain.
+    */
+    Run run (int latency, float wetGain, bool useCaptureAndMix)
+    {
+        BypassCrossfade bypass;
+        bypass.prepare (sampleRate, maxBlockSize, numChannels, latency);
+
+        std::vector<std::vector<float>> buffers ((size_t) numChannels, std::vector<float> ((size_t) maxBlockSize));
+        std::vector<float*> channels;
+
+        for (auto& buffer : buffers)
+            channels.push_back (buffer.data());
+
+        const auto step = 1.0 / (BypassCrossfade::fadeSeconds * sampleRate);
+        auto weight = 1.0;
+        Run result;
+
+        for (int start = 0, call = 0; start < numSamples; ++call)
+        {
+            const auto blockSize = juce::jmin (primes[call % juce::numElementsInArray (primes)], numSamples - start);
+
+            // Switches land where the block starts, as they would from a host
+            const auto bypassed = isBypassedAt (start);
+            bypass.setBypassed (bypassed);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    channels[(size_t) ch][i] = getInput (ch, start + i);
+
+            if (useCaptureAndMix)
+            {
+                bypass.capture (channels.data(), numChannels, blockSize);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        channels[(size_t) ch][i] = wetGain * getDelayedInput (ch, start + i, latency);
+
+                bypass.mix (channels.data(), numChannels, blockSize);
+            }
+            else
+            {
+                bypass.passThrough (channels.data(), numChannels, blockSize);
+            }
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                weight = juce::jlimit (0.0, 1.0, weight + (bypassed ? -step : step));
+                result.expected.push_back (weight);
+            }
+
+            result.output.insert (result.output.end(), channels[0], channels[0] + blockSize);
+            start += blockSize;
+        }
+
+        return result;
+    }
+
+    /** The largest difference from the input delayed by the latency. */
+    float checkAlignment (int latency, bool useCaptureAndMix)
+    {
+        const auto output = run (latency, 1.0f, useCaptureAndMix).output;
+        auto worst = 0.0f;
+
+        for (int i = 0; i < numSamples; ++i)
+            worst = juce::jmax (worst, std::abs (output[(size_t) i] - getDelayedInput (0, i, latency)));
+
+        return worst;
+    }
+
+    /** The largest difference between the processed path's weight, read back
+        from the output, and a straight fade from each switch.
+    */
+    double checkFade (int latency)
+    {
+        const auto result = run (latency, 2.0f, true);
+        auto worst = 0.0;
+
+        for (int i = latency; i < numSamples; ++i)
+        {
+            const auto dry = (double) getDelayedInput (0, i, latency);
+
+            // Too quiet to read the weight back from
+            if (std::abs (dry) < 0.05)
+                continue;
+
+            const auto weight = (double) result.output[(size_t) i] / dry - 1.0;
+            worst = juce::jmax (worst, std::abs (weight - result.expected[(size_t) i]));
+        }
+
+        return worst;
+    }
+}
+
+int main()
+{
+    // The fade's gain steps are added up in float, a few hundred of them
+    constexpr double fadeTolerance = 1.0e-4;
+
+    std::printf ("blocks of cycling primes up to %d, tolerance %g, fade tolerance %g\n\n",
+                 maxBlockSize, (double) tolerance, fadeTolerance);
+    std::printf ("%-8s %16s %16s %16s\n", "latency", "passThrough", "capture + mix", "fade");
+
+    auto failed = false;
+
+    for (auto latency : latencies)
+    {
+        const auto passThrough = checkAlignment (latency, false);
+        const auto mixed = checkAlignment (latency, true);
+        const auto fade = checkFade (latency);
+        const auto passed = passThrough <= tolerance && mixed <= tolerance && fade <= fadeTolerance;
+
+        std::printf ("%-8d %16g %16g %16g  %s\n", latency, (double) passThrough, (double) mixed, fade,
+                     passed ? "ok" : "FAILED");
+
+        failed = failed || ! passed;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,168 @@
+/*
+    Checks that the error-feedback topology keeps its accuracy where the
+    direct forms lose theirs: low, high-Q sections at high sample rates.
+
+    Each case runs two seconds of white noise through one band on every
+    channel of a full lane group, through FilterEngine with each instruction
+    set forced, once as a direct form I and once as error feedback. The SNR
+    is against a direct form I run in double precision on the same cookbook
+    coefficients, leaving out the first quarter so the start-up transient
+    doesn't count. Error feedback must reach a minimum SNR of its own and
+    beat direct form I by a minimum margin. Instruction sets this CPU lacks
+    are skipped.
+*/
+
+#include <JuceHeader.h>
+#include "DSP/FilterEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace iir;
+
+namespace
+{
+    constexpr double secondsOfNoise = 2.0;
+
+    // Measured at about 14 dB for direct form I and 110 dB for error feedback
+    // on the first case, -4 dB and 102 dB on the second and 40 dB and 119 dB
+    // on the third; the thresholds leave room for other compilers
+    constexpr double minimumSnr = 95.0, minimumGain = 70.0;
+
+    struct Case
+    {
+        const char* name;
+        FilterType type;
+        float frequency, q, gainDb;
+        double sampleRate;
+    };
+
+    const Case cases[] =
+    {
+        { "lp 20 Q 10 at 96k",   FilterType::lowPass, 20.0f, 10.0f,  0.0f,  96000.0 },
+        { "lp 10 Q 10 at 192k",  FilterType::lowPass, 10.0f, 10.0f,  0.0f, 192000.0 },
+        { "bell 30 +12 at 192k", FilterType::peak,    30.0f,  8.0f, 12.0f, 192000.0 }
+    };
+
+    BandSettings makeBand (const Case& c, Topology topology)
+    {
+        BandSettings band;
+        band.enabled = true;
+        band.type = c.type;
+        band.frequency = c.frequency;
+        band.q = c.q;
+        band.gainDb = c.gainDb;
+        band.topology = topology;
+        return band;
+    }
+
+    std::vector<double> getReference (const Case& c, const std::vector<float>& input)
+    {
+        const auto r = BiquadCoefficients<double>::design (makeBand (c, Topology::directForm1), c.sampleRate);
+
+        std::vector<double> result (input.size());
+        double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            const auto x = (double) input[i];
+            const auto y = r.b0 * x + r.b1 * x1 + r.b2 * x2 - r.a1 * y1 - r.a2 * y2;
+            x2 = x1; x1 = x;
+            y2 = y1; y1 = y;
+            result[i] = y;
+        }
+
+        return result;
+    }
+
+    /** The worst SNR over every lane, so a lane the kernel gets wrong can't
+        hide behind the others.
+    */
+    double measureSnr (InstructionSet isa, const Case& c, Topology topology,
+                       const std::vector<float>& input, const std::vector<double>& reference)
+    {
+        FilterEngine engine;
+        engine.setForcedInstructionSet (isa);
+        engine.setMaxNumWorkers (0);
+
+        const auto numChannels = InstructionSets::getLaneWidth (isa);
+        const auto numSamples = (int) input.size();
+        engine.prepare (c.sampleRate, numSamples, numChannels);
+
+        FilterSettings settings;
+        settings.bands[0] = makeBand (c, topology);
+        engine.setSettings (settings);
+
+        std::vector<std::vector<float>> buffers ((size_t) numChannels, input);
+        std::vector<float*> channels;
+
+        for (auto& buffer : buffers)
+            channels.push_back (buffer.data());
+
+        engine.process (channels.data(), numChannels, numSamples);
+
+        auto worst = std::numeric_limits<double>::max();
+
+        for (const auto& output : buffers)
+        {
+            double signal = 0.0, noise = 0.0;
+
+            for (size_t i = output.size() / 4; i < output.size(); ++i)
+            {
+                signal += reference[i] * reference[i];
+                noise += juce::square ((double) output[i] - reference[i]);
+            }
+
+            worst = std::min (worst, noise > 0.0 ? 10.0 * std::log10 (signal / noise) : 999.0);
+        }
+
+        return worst;
+    }
+}
+
+int main()
+{
+    std::printf ("SNR against double direct form I, error feedback needs %g dB and %g dB over direct form I\n\n",
+                 minimumSnr, minimumGain);
+    std::printf ("%-9s %-20s %10s %10s %10s\n", "isa", "case", "DF1", "ErrFb", "gain");
+
+    std::mt19937 random (1);
+    std::uniform_real_distribution<float> noise (-0.5f, 0.5f);
+    auto failed = false;
+
+    for (const auto& c : cases)
+    {
+        std::vector<float> input ((size_t) (secondsOfNoise * c.sampleRate));
+
+        for (auto& x : input)
+            x = noise (random);
+
+        const auto reference = getReference (c, input);
+
+        for (int i = 0; i < numInstructionSets; ++i)
+        {
+            const auto isa = (InstructionSet) i;
+
+            if (! InstructionSets::isSupported (isa))
+            {
+                std::printf ("%-9s skipped, not supported by this CPU\n", InstructionSets::getName (isa));
+                continue;
+            }
+
+            const auto directForm = measureSnr (isa, c, Topology::directForm1, input, reference);
+            const auto errorFeedback = measureSnr (isa, c, Topology::errorFeedback, input, reference);
+            const auto passed = errorFeedback >= minimumSnr && errorFeedback - directForm >= minimumGain;
+
+            std::printf ("%-9s %-20s %8.1fdB %8.1fdB %8.1fdB  %s\n", InstructionSets::getName (isa), c.name,
+                         directForm, errorFeedback, errorFeedback - directForm, passed ? "ok" : "FAILED");
+
+            failed = failed || ! passed;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
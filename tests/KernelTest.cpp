@@ -0,0 +1,528 @@
+/*
+    Checks the float section kernels of every instruction set and topology
+    against checked-in golden responses, and their speed against a
+    baseline recorded on the same machine.
+
+        IIRKernelTest responses <golden dir>
+        IIRKernelTest throughput <baseline.csv> <tolerance %>
+
+    The golden impulse responses come from a plain direct form I biquad run in
+    double precision on the coefficients each topology is designed from: the
+    cookbook biquad, or for the state variable filter the exact transfer
+    function of its own coefficients, as it designs with an approximated tan.
+    The frequency responses are the DFT of those impulse responses at
+    logarithmically spaced frequencies. Each kernel runs through FilterEngine
+    with its instruction set forced, over one lane more than a full group and
+    with the impulse on each channel a sample later than on the one before, so
+    a lane leaking into another shows up as well as a wrong response.
+    Instruction sets this CPU lacks are skipped.
+
+    The throughput is in ns per sample per channel for eight bands of one
+    topology over a full lane group, and fails when slower than the baseline
+    by more than the tolerance. It is machine dependent, so the baseline is
+    recorded on the machine that runs the test and not kept in the tree. Both
+    references are written by
+
+        IIRKernelTest generate <golden dir>
+        IIRKernelTest baseline <baseline.csv>
+
+    The golden files hold little-endian float32, the cases one after another.
+*/
+
+#include <JuceHeader.h>
+#include "DSP/FilterEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace iir;
+
+namespace
+{
+    constexpr int numImpulseSamples = 1024;
+    constexpr int numFrequencies = 64;
+    constexpr double lowestFrequency = 20.0, highestFrequency = 20000.0;
+
+    // Largest error allowed in float, relative to the peak of the golden
+    // impulse or frequency response, per topology. The direct forms lose
+    // precision as the poles near DC, up to about 7e-3 for a bell at 60 Hz at
+    // 96 kHz; the others stay below 2e-5. A kernel or coefficient mapping that
+    // is wrong rather than rounded lands orders of magnitude above these
+    constexpr double tolerances[] = { 1.0e-2, 1.0e-2, 1.0e-4, 1.0e-4, 1.0e-4, 1.0e-4 };
+
+    const char* const topologyNames[] = { "directForm1", "transposedDirectForm2", "stateVariable",
+                                          "normalisedLattice", "coupledForm", "errorFeedback" };
+
+    struct Case
+    {
+        const char* name;
+        FilterType type;
+        float frequency, q, gainDb;
+        double sampleRate;
+    };
+
+    const Case cases[] =
+    {
+        { "lp 1k",           FilterType::lowPass,    1000.0f, 0.707f,  0.0f,  48000.0 },
+        { "hp 200",          FilterType::highPass,    200.0f, 0.707f,  0.0f,  48000.0 },
+        { "bp 2k",           FilterType::bandPass,   2000.0f, 2.0f,    0.0f,  48000.0 },
+        { "notch 1k",        FilterType::notch,      1000.0f, 4.0f,    0.0f,  48000.0 },
+        { "bell 1k +6",      FilterType::peak,       1000.0f, 1.0f,    6.0f,  48000.0 },
+        { "low shelf 200",   FilterType::lowShelf,    200.0f, 0.707f,  6.0f,  48000.0 },
+        { "high shelf 5k",   FilterType::highShelf,  5000.0f, 0.707f, -6.0f,  48000.0 },
+        { "lp 40 at 96k",    FilterType::lowPass,      40.0f, 0.707f,  0.0f,  96000.0 },
+        { "bell 60 +12 96k", FilterType::peak,         60.0f, 4.0f,   12.0f,  96000.0 }
+    };
+
+    constexpr int numCases = (int) (sizeof (cases) / sizeof (cases[0]));
+
+    BandSettings makeBand (const Case& c, Topology topology)
+    {
+        BandSettings band;
+        band.enabled = true;
+        band.type = c.type;
+        band.frequency = c.frequency;
+        band.q = c.q;
+        band.gainDb = c.gainDb;
+        band.topology = topology;
+        return band;
+    }
+
+    /** The bilinear transform of the SVF's analogue prototype,
+        H(s) = m0 + (m1 s + m2) / (s^2 + k s + 1), with g = a2 / a1 as the
+        prewarped tan.
+    */
+    BiquadCoefficients<double> toBiquad (const SvfCoefficients<double>& c)
+    {
+        const auto g = c.a2 / c.a1;
+        const auto gg = g * g;
+        const auto n0 = c.m0, n1 = (c.m0 * c.k + c.m1) * g, n2 = (c.m0 + c.m2) * gg;
+        const auto d0 = 1.0 + c.k * g + gg;
+
+        return { (n0 + n1 + n2) / d0,
+                 2.0 * (n2 - n0) / d0,
+                 (n0 - n1 + n2) / d0,
+                 2.0 * (gg - 1.0) / d0,
+                 (1.0 - c.k * g + gg) / d0 };
+    }
+
+    std::vector<double> getReferenceImpulse (const Case& c, Topology topology)
+    {
+        const auto band = makeBand (c, topology);
+        const auto r = topology == Topology::stateVariable
+                         ? toBiquad (SectionCoefficients<double>::design (band, c.sampleRate).svf)
+                         : BiquadCoefficients<double>::design (band, c.sampleRate);
+
+        std::vector<double> result ((size_t) numImpulseSamples);
+        double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+        for (int i = 0; i < numImpulseSamples; ++i)
+        {
+            const auto x = i == 0 ? 1.0 : 0.0;
+            const auto y = r.b0 * x + r.b1 * x1 + r.b2 * x2 - r.a1 * y1 - r.a2 * y2;
+            x2 = x1; x1 = x;
+            y2 = y1; y1 = y;
+            result[(size_t) i] = y;
+        }
+
+        return result;
+    }
+
+    template <typename SampleType>
+    std::vector<std::complex<double>> getFrequencyResponse (const SampleType* impulse, double sampleRate)
+    {
+        std::vector<std::complex<double>> result;
+
+        for (int f = 0; f < numFrequencies; ++f)
+        {
+            const auto frequency = lowestFrequency * std::pow (highestFrequency / lowestFrequency,
+                                                               f / (double) (numFrequencies - 1));
+            const auto w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+            std::complex<double> sum;
+
+            for (int i = 0; i < numImpulseSamples; ++i)
+                sum += (double) impulse[i] * std::polar (1.0, -w * i);
+
+            result.push_back (sum);
+        }
+
+        return result;
+    }
+
+    //==============================================================================
+    std::string getGoldenPath (const std::string& directory, Topology topology, const char* kind)
+    {
+        return directory + "/" + topologyNames[(int) topology] + "." + kind + ".bin";
+    }
+
+    bool writeFloats (const std::string& path, const std::vector<float>& values)
+    {
+        std::ofstream file (path, std::ios::binary);
+
+        for (auto value : values)
+        {
+            uint32_t bits;
+            std::memcpy (&bits, &value, sizeof (bits));
+            const char bytes[] = { (char) bits, (char) (bits >> 8), (char) (bits >> 16), (char) (bits >> 24) };
+            file.write (bytes, sizeof (bytes));
+        }
+
+        return file.good();
+    }
+
+    bool readFloats (const std::string& path, size_t numValues, std::vector<float>& values)
+    {
+        std::ifstream file (path, std::ios::binary);
+        std::vector<unsigned char> bytes (numValues * 4 + 1);
+        file.read (reinterpret_cast<char*> (bytes.data()), (std::streamsize) bytes.size());
+
+        if ((size_t) file.gcount() != numValues * 4)
+            return false;
+
+        values.resize (numValues);
+
+        for (size_t i = 0; i < numValues; ++i)
+        {
+            const auto* b = bytes.data() + i * 4;
+            const auto bits = (uint32_t) b[0] | (uint32_t) b[1] << 8 | (uint32_t) b[2] << 16 | (uint32_t) b[3] << 24;
+            std::memcpy (&values[i], &bits, sizeof (bits));
+        }
+
+        return true;
+    }
+
+    int generate (const std::string& directory)
+    {
+        for (int t = 0; t < numTopologies; ++t)
+        {
+            std::vector<float> impulses, responses;
+
+            for (const auto& c : cases)
+            {
+                const auto impulse = getReferenceImpulse (c, (Topology) t);
+                impulses.insert (impulses.end(), impulse.begin(), impulse.end());
+
+                for (auto h : getFrequencyResponse (impulse.data(), c.sampleRate))
+                {
+                    responses.push_back ((float) h.real());
+                    responses.push_back ((float) h.imag());
+                }
+            }
+
+            if (! writeFloats (getGoldenPath (directory, (Topology) t, "impulse"), impulses)
+                || ! writeFloats (getGoldenPath (directory, (Topology) t, "response"), responses))
+            {
+                std::printf ("can't write to %s\n", directory.c_str());
+                return 1;
+            }
+        }
+
+        std::printf ("wrote the golden responses for %d topologies to %s\n", numTopologies, directory.c_str());
+        return 0;
+    }
+
+    //==============================================================================
+    struct Errors
+    {
+        double impulse = 0.0, response = 0.0;
+    };
+
+    /** Runs one band through the engine with the impulse on each of
+        laneWidth + 1 channels, delayed by the channel's index, and returns the
+        worst error over every channel relative to the golden peaks.
+    */
+    Errors measure (InstructionSet isa, const Case& c, Topology topology,
+                    const float* goldenImpulse, const float* goldenResponse)
+    {
+        FilterEngine engine;
+        engine.setForcedInstructionSet (isa);
+        engine.setMaxNumWorkers (0);
+
+        const auto numChannels = InstructionSets::getLaneWidth (isa) + 1;
+        const auto numSamples = numImpulseSamples + numChannels;
+        engine.prepare (c.sampleRate, numSamples, numChannels);
+
+        FilterSettings settings;
+        settings.bands[0] = makeBand (c, topology);
+        engine.setSettings (settings);
+
+        std::vector<std::vector<float>> buffers ((size_t) numChannels, std::vector<float> ((size_t) numSamples));
+        std::vector<float*> channels;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            buffers[(size_t) channel][(size_t) channel] = 1.0f;
+            channels.push_back (buffers[(size_t) channel].data());
+        }
+
+        engine.process (channels.data(), numChannels, numSamples);
+
+        double impulsePeak = 0.0, responsePeak = 0.0;
+
+        for (int i = 0; i < numImpulseSamples; ++i)
+            impulsePeak = std::max (impulsePeak, (double) std::abs (goldenImpulse[i]));
+
+        for (int f = 0; f < numFrequencies; ++f)
+            responsePeak = std::max (responsePeak, std::abs (std::complex<double> (goldenResponse[2 * f], goldenResponse[2 * f + 1])));
+
+        Errors errors;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* output = channels[(size_t) channel];
+
+            // Nothing may arrive before the channel's own impulse
+            for (int i = 0; i < channel; ++i)
+                errors.impulse = std::max (errors.impulse, (double) std::abs (output[i]) / impulsePeak);
+
+            for (int i = 0; i < numImpulseSamples; ++i)
+                errors.impulse = std::max (errors.impulse, std::abs ((double) output[channel + i] - goldenImpulse[i]) / impulsePeak);
+
+            const auto response = getFrequencyResponse (output + channel, c.sampleRate);
+
+            for (int f = 0; f < numFrequencies; ++f)
+            {
+                const std::complex<double> golden (goldenResponse[2 * f], goldenResponse[2 * f + 1]);
+                errors.response = std::max (errors.response, std::abs (response[(size_t) f] - golden) / responsePeak);
+            }
+        }
+
+        return errors;
+    }
+
+    int checkResponses (const std::string& directory)
+    {
+        std::printf ("errors relative to the golden peak, tolerance");
+
+        for (int t = 0; t < numTopologies; ++t)
+            std::printf ("%s %s %g", t > 0 ? "," : "", topologyNames[t], tolerances[t]);
+
+        std::printf ("\n\n%-9s %-22s %-16s %12s %12s\n", "isa", "topology", "case", "impulse", "response");
+
+        auto failed = false;
+
+        for (int i = 0; i < numInstructionSets; ++i)
+        {
+            const auto isa = (InstructionSet) i;
+
+            if (! InstructionSets::isSupported (isa))
+            {
+                std::printf ("%-9s skipped, not supported by this CPU\n", InstructionSets::getName (isa));
+                continue;
+            }
+
+            for (int t = 0; t < numTopologies; ++t)
+            {
+                const auto topology = (Topology) t;
+                std::vector<float> impulses, responses;
+
+                if (! readFloats (getGoldenPath (directory, topology, "impulse"), (size_t) (numCases * numImpulseSamples), impulses)
+                    || ! readFloats (getGoldenPath (directory, topology, "response"), (size_t) (numCases * numFrequencies * 2), responses))
+                {
+                    std::printf ("missing or wrongly sized golden files for %s in %s\n", topologyNames[t], directory.c_str());
+                    return 1;
+                }
+
+                for (int n = 0; n < numCases; ++n)
+                {
+                    const auto errors = measure (isa, cases[n], topology,
+                                                 impulses.data() + n * numImpulseSamples,
+                                                 responses.data() + n * numFrequencies * 2);
+                    const auto passed = errors.impulse <= tolerances[t] && errors.response <= tolerances[t];
+
+                    std::printf ("%-9s %-22s %-16s %12.3g %12.3g  %s\n", InstructionSets::getName (isa),
+                                 topologyNames[t], cases[n].name, errors.impulse, errors.response,
+                                 passed ? "ok" : "FAILED");
+
+                    failed = failed || ! passed;
+                }
+            }
+        }
+
+        return failed ? 1 : 0;
+    }
+
+    //==============================================================================
+    using Baseline = std::map<std::pair<std::string, std::string>, double>;
+
+    /** Best of several runs of eight bands of one topology over a full lane group. */
+    double measureThroughput (InstructionSet isa, Topology topology)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512, numBlocks = 1000, numRuns = 5;
+
+        FilterEngine engine;
+        engine.setForcedInstructionSet (isa);
+        engine.setMaxNumWorkers (0);
+
+        const auto numChannels = InstructionSets::getLaneWidth (isa);
+        engine.prepare (sampleRate, blockSize, numChannels);
+
+        FilterSettings settings;
+
+        for (int band = 0; band < maxBands; ++band)
+        {
+            auto& b = settings.bands[(size_t) band];
+            b.enabled = true;
+            b.type = FilterType::peak;
+            b.frequency = 100.0f * (float) (band + 1);
+            b.q = 1.0f;
+            b.gainDb = 3.0f;
+            b.topology = topology;
+        }
+
+        engine.setSettings (settings);
+
+        std::mt19937 random (1);
+        std::uniform_real_distribution<float> noise (-0.5f, 0.5f);
+        std::vector<std::vector<float>> buffers ((size_t) numChannels, std::vector<float> ((size_t) blockSize));
+        std::vector<float*> channels;
+
+        for (auto& buffer : buffers)
+        {
+            std::generate (buffer.begin(), buffer.end(), [&] { return noise (random); });
+            channels.push_back (buffer.data());
+        }
+
+        auto best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run <= numRuns; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int block = 0; block < numBlocks; ++block)
+                engine.process (channels.data(), numChannels, blockSize);
+
+            const auto seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+            // The first run only warms up
+            if (run > 0)
+                best = std::min (best, seconds * 1.0e9 / ((double) numBlocks * blockSize * numChannels));
+        }
+
+        return best;
+    }
+
+    bool readBaseline (const std::string& path, Baseline& baseline)
+    {
+        std::ifstream file (path);
+        std::string line;
+
+        if (! std::getline (file, line))
+            return false;
+
+        while (std::getline (file, line))
+        {
+            std::istringstream fields (line);
+            std::string isa, topology, nanoseconds;
+
+            if (std::getline (fields, isa, ',') && std::getline (fields, topology, ',') && std::getline (fields, nanoseconds))
+                baseline[{ isa, topology }] = std::stod (nanoseconds);
+        }
+
+        return true;
+    }
+
+    int writeBaseline (const std::string& path)
+    {
+        std::ofstream file (path);
+        file << "isa,topology,nsPerSample\n";
+
+        for (int i = 0; i < numInstructionSets; ++i)
+        {
+            const auto isa = (InstructionSet) i;
+
+            if (! InstructionSets::isSupported (isa))
+                continue;
+
+            for (int t = 0; t < numTopologies; ++t)
+            {
+                char nanoseconds[32];
+                std::snprintf (nanoseconds, sizeof (nanoseconds), "%.3f", measureThroughput (isa, (Topology) t));
+                file << InstructionSets::getName (isa) << "," << topologyNames[t] << "," << nanoseconds << "\n";
+            }
+        }
+
+        std::printf ("wrote the throughput baseline to %s\n", path.c_str());
+        return file.good() ? 0 : 1;
+    }
+
+    int checkThroughput (const std::string& path, double tolerancePercent)
+    {
+       #if JUCE_DEBUG
+        juce::ignoreUnused (path, tolerancePercent);
+        std::printf ("skipped: a Debug build says nothing about the speed of the kernels\n");
+        return 0;
+       #else
+        Baseline baseline;
+
+        if (! readBaseline (path, baseline))
+        {
+            std::printf ("can't read the baseline %s\n", path.c_str());
+            return 1;
+        }
+
+        std::printf ("ns per sample per channel, failing when more than %g%% above the baseline\n\n", tolerancePercent);
+        std::printf ("%-9s %-22s %10s %10s %9s\n", "isa", "topology", "measured", "baseline", "change");
+
+        auto failed = false;
+
+        for (int i = 0; i < numInstructionSets; ++i)
+        {
+            const auto isa = (InstructionSet) i;
+
+            if (! InstructionSets::isSupported (isa))
+                continue;
+
+            for (int t = 0; t < numTopologies; ++t)
+            {
+                const auto measured = measureThroughput (isa, (Topology) t);
+                const auto entry = baseline.find ({ InstructionSets::getName (isa), topologyNames[t] });
+
+                if (entry == baseline.end())
+                {
+                    std::printf ("%-9s %-22s %10.3f %10s\n", InstructionSets::getName (isa), topologyNames[t], measured, "none");
+                    continue;
+                }
+
+                const auto change = (measured / entry->second - 1.0) * 100.0;
+                const auto passed = change <= tolerancePercent;
+
+                std::printf ("%-9s %-22s %10.3f %10.3f %+8.1f%%  %s\n", InstructionSets::getName (isa), topologyNames[t],
+                             measured, entry->second, change, passed ? "ok" : "FAILED");
+
+                failed = failed || ! passed;
+            }
+        }
+
+        return failed ? 1 : 0;
+       #endif
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::string mode = argc > 2 ? argv[1] : "";
+
+    if (mode == "responses")                  return checkResponses (argv[2]);
+    if (mode == "throughput" && argc > 3)     return checkThroughput (argv[2], std::atof (argv[3]));
+    if (mode == "generate")                   return generate (argv[2]);
+    if (mode == "baseline")                   return writeBaseline (argv[2]);
+
+    std::printf ("usage: %s responses <golden dir>\n"
+                 "       %s throughput <baseline.csv> <tolerance %%>\n"
+                 "       %s generate <golden dir>\n"
+                 "       %s baseline <baseline.csv>\n", argv[0], argv[0], argv[0], argv[0]);
+    return 1;
+}